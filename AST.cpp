@@ -1,9 +1,13 @@
 #include "AST.h"
+#include "Bytecode.h"
+#include "SymbolTable.h"
 #include "TokenStream.h"
+#include "Symbols.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <stack>
-#include <math.h>
+#include <utility>
 using namespace std;
 
 /**
@@ -19,279 +23,1708 @@ AST::AST(vector<Token> &postfix) : root_(nullptr)
    constructTree(postfix);
 }
 
+/**
+ * @brief Construct a new AST object
+ * same as above but allocates the nodes from an arena that can be shared
+ * with other trees, so trees built for one calculation are released
+ * together
+ *
+ * @param postfix : vector of tokens in postfix form
+ * @param arena : arena to allocate the nodes from
+ */
+AST::AST(vector<Token> &postfix, shared_ptr<Arena> arena) : root_(nullptr),
+                                                            arena_(move(arena))
+{
+   constructTree(postfix);
+}
+
 /**
  * @brief Construct a new AST object
  * constructs an AST via only a single token, this is used to initialize the
  * map of variables
  * @param t
  */
-AST::AST(Token t) : root_(nullptr)
+AST::AST(const Token &t) : root_(nullptr)
+{
+   root_ = makeNode(t);
+}
+
+/**
+ * @brief Construct a new AST object
+ * same as above but allocates the node from the given arena
+ *
+ * @param t : token of the only node
+ * @param arena : arena to allocate the node from
+ */
+AST::AST(const Token &t, shared_ptr<Arena> arena) : root_(nullptr),
+                                                    arena_(move(arena))
+{
+   root_ = makeNode(t);
+}
+
+/**
+ * @brief Construct a new AST object
+ * copy constructor that calls copyTree()
+ *
+ * @param ast
+ */
+AST::AST(const AST &ast) : root_(nullptr)
+{
+   root_ = copyTree(ast.root_);
+}
+
+/**
+ * @brief Construct a new AST object
+ * copies the tree of ast into the given arena
+ *
+ * @param ast : AST to copy
+ * @param arena : arena to allocate the copied nodes from
+ */
+AST::AST(const AST &ast, shared_ptr<Arena> arena) : root_(nullptr),
+                                                    arena_(move(arena))
+{
+   root_ = copyTree(ast.root_);
+}
+
+/**
+ * @brief operator=
+ * this is an assignment operator that assigns the ast passed in
+ *
+ * @param ast : AST that will be assigned
+ * @return AST& : new AST
+ */
+AST &AST::operator=(const AST &ast)
+{
+   if (&ast != this) //check for self assignment
+   {
+      clear();
+      root_ = copyTree(ast.root_);
+   }                          
+   return *this;
+}
+
+/**
+ * @brief Construct a new AST object
+ * move constructor, the nodes and the arena are taken from ast and ast is
+ * left empty
+ *
+ * @param ast : AST to move from
+ */
+AST::AST(AST &&ast) noexcept
+    : root_(ast.root_), arena_(move(ast.arena_)),
+      borrowed_(move(ast.borrowed_)),
+      borrowedValues_(move(ast.borrowedValues_)), value_(move(ast.value_)),
+      dependencies_(move(ast.dependencies_)), code_(move(ast.code_))
+{
+   ast.root_ = nullptr;
+}
+
+/**
+ * @brief operator=
+ * move assignment, the nodes and the arena are taken from ast and ast is
+ * left empty
+ *
+ * @param ast : AST to move from
+ * @return AST& : this AST
+ */
+AST &AST::operator=(AST &&ast) noexcept
+{
+   if (&ast != this)
+   {
+      root_ = ast.root_;
+      arena_ = move(ast.arena_);
+      borrowed_ = move(ast.borrowed_);
+      borrowedValues_ = move(ast.borrowedValues_);
+      value_ = move(ast.value_);
+      dependencies_ = move(ast.dependencies_);
+      code_ = move(ast.code_);
+      ast.root_ = nullptr;
+   }
+   return *this;
+}
+
+/**
+ * @brief Destroy the AST object
+ * the nodes are released together with the arena. A value can borrow a
+ * value that borrows another one, so the borrowed values are released one
+ * at a time from a list instead of from the destructor of each other, and
+ * a long chain of definitions does not recurse.
+ */
+AST::~AST()
+{
+   static thread_local bool releasing = false;
+   static thread_local vector<shared_ptr<const AST> > pending;
+   for (size_t i = 0; i < borrowedValues_.size(); i++)
+   {
+      pending.push_back(move(borrowedValues_[i]));
+   }
+   if (value_ != nullptr)
+   {
+      pending.push_back(move(value_));
+   }
+   if (releasing)
+   {
+      // an outer destructor is releasing the list
+      return;
+   }
+   releasing = true;
+   while (!pending.empty())
+   {
+      shared_ptr<const AST> last = move(pending.back());
+      pending.pop_back();
+      last.reset();
+   }
+   releasing = false;
+}
+
+/**
+ * @brief clear
+ * this function clears the entire tree at once by releasing the arena. If
+ * the arena is shared with other trees only this tree's reference is
+ * dropped, otherwise the arena is reset so its memory can be reused
+ */
+void AST::clear()
+{
+   root_ = nullptr;
+   code_.reset();
+   borrowed_.clear();
+   borrowedValues_.clear();
+   value_.reset();
+   dependencies_.clear();
+   if (arena_ != nullptr && arena_.use_count() == 1)
+   {
+      arena_->reset();
+   }
+   else
+   {
+      arena_.reset();
+   }
+}
+
+/**
+ * @brief makeNode
+ * this function creates a new node inside the arena of the tree, creating
+ * the arena first if the tree does not have one yet
+ *
+ * @param t : token of the node
+ * @param left : left node pointer
+ * @param right : right node pointer
+ * @return Node* : the new node
+ */
+AST::Node *AST::makeNode(const Token &t, Node *left, Node *right)
+{
+   if (arena_ == nullptr)
+   {
+      arena_ = make_shared<Arena>();
+   }
+   return arena_->create<Node>(t, left, right);
+}
+
+/**
+ * @brief makeBigNumber
+ * this function creates a number node whose value does not fit in a token,
+ * the value is copied into the arena of the tree with the node
+ *
+ * @param value : value of the number
+ * @return Node* : the new node
+ */
+AST::Node *AST::makeBigNumber(const Rational &value)
+{
+   Node *node = makeNode(Token(number));
+   node->big = arena_->create<Rational>(value);
+   return node;
+}
+
+/**
+ * @brief copyTree
+ * this function takes in the root of the tree to be copied and copies
+ * the tree without recursion. It then returns the new node of the copy.
+ *
+ * @param oldRoot : root of tree to be copied
+ * @return Node* : new tree root
+ */
+AST::Node *AST::copyTree(const Node *oldRoot)
+{
+   // a simplified tree may share subtrees, the copy shares them too
+   unordered_map<const Node *, Node *> copies;
+   return copyTree(oldRoot, copies);
+}
+
+/**
+ * @brief copyTree
+ * same as above for a tree whose subtrees may be shared, each node is
+ * copied once and the copy is shared the same way. A post order walk with
+ * a stack of its own copies the operands of a node before the node.
+ *
+ * @param oldRoot : root of tree to be copied
+ * @param copies : copy of each node that was copied already
+ * @return Node* : new tree root
+ */
+AST::Node *AST::copyTree(const Node *oldRoot,
+                         unordered_map<const Node *, Node *> &copies)
+{
+   if (oldRoot == nullptr)
+   {
+      return nullptr;
+   }
+
+   vector<pair<const Node *, bool> > walk;
+   walk.push_back(make_pair(oldRoot, false));
+   while (!walk.empty())
+   {
+      const Node *node = walk.back().first;
+      bool visited = walk.back().second;
+      walk.pop_back();
+      if (copies.find(node) != copies.end())
+      {
+         // a shared subtree that was reached before
+         continue;
+      }
+      if (!visited && node->left != nullptr)
+      {
+         walk.push_back(make_pair(node, true));
+         walk.push_back(make_pair(node->right, false));
+         walk.push_back(make_pair(node->left, false));
+         continue;
+      }
+
+      Node *copy = makeNode(node->token);
+      // a value that does not fit lives in the old arena, so it is copied as
+      // well
+      if (node->big != nullptr)
+      {
+         copy->big = arena_->create<Rational>(*node->big);
+      }
+      if (node->left != nullptr)
+      {
+         copy->left = copies[node->left];
+         copy->right = copies[node->right];
+      }
+      copies[node] = copy;
+   }
+   return copies[oldRoot];
+}
+
+/**
+ * @brief constructTree
+ * this function takes in a postfix vector of tokens and creates an AST,
+ * setting the root_ member variable to the root
+ *
+ * @param postfix : vector of tokens in postfix form
+ */
+void AST::constructTree(vector<Token> &postfix)
+{
+   stack<Node *> stack;
+
+   for (int i = 0; i < postfix.size(); i++)
+   {
+      if (isOperator(postfix[i]) || isPower(postfix[i]))
+      {
+
+         // the operand on top of the stack is the right operand
+         Node *right = stack.top();
+         stack.pop();
+
+         Node *left = stack.top();
+         stack.pop();
+
+         // construct a new binary tree whose root is the operator and whose
+         // left and right children point to the two operands
+         Node *node = makeNode(postfix[i], left, right);
+
+         // push the current node into the stack
+         stack.push(node);
+      }
+      else if (isOperand(postfix[i]))
+      {
+         // if number or variable, push onto stack
+         stack.push(makeNode(postfix[i]));
+      }
+   }
+   // set root to point to tree
+   root_ = stack.top();
+}
+
+/**
+ * @brief simplify
+ * this method takes in the table of variables and builds the simplified
+ * tree, with every variable replaced by its stored AST and every
+ * calculation done that can be done exactly. Operands that are 0 or 1
+ * are removed, like terms are collected and the numbers of a sum or
+ * product are gathered. A tree that evaluates to a number is run on its
+ * bytecode instead and no tree is built.
+ * @param variables: an array that holds the variables that can be stored
+ * @param arena : arena for the copy, a new one is created if it is null
+ * @return AST : returned simplified AST
+ */
+AST AST::simplify(SymbolTable &variables, shared_ptr<Arena> arena)
+{
+   int64_t value;
+   if (evaluate(variables, value))
+   {
+      return AST(Token::fromNumber(value), move(arena));
+   }
+   return simplifyTree(variables, move(arena));
+}
+
+/**
+ * @brief simplify
+ * same as above for a tree that is simplified once. The tree is compiled
+ * into the given bytecode instead of code of its own, so a line that
+ * evaluates to a number does not allocate for its code.
+ *
+ * @param variables : table of the trees assigned to the variables
+ * @param scratch : bytecode the tree is compiled into
+ * @param arena : arena for the copy, a new one is created if it is null
+ * @return AST : returned simplified AST
+ */
+AST AST::simplify(SymbolTable &variables, Bytecode &scratch,
+                  shared_ptr<Arena> arena)
+{
+   int64_t value;
+   if (evaluate(variables, value, scratch))
+   {
+      return AST(Token::fromNumber(value), move(arena));
+   }
+   return simplifyTree(variables, move(arena));
+}
+
+/**
+ * @brief simplifyTree
+ * same as simplify but always walks the tree, this is what simplify falls
+ * back to when the bytecode cannot evaluate the tree. Identical subtrees
+ * of the result are one shared node, so a chain of definitions that each
+ * use the one before twice is built in linear time and memory. Subtrees of
+ * this tree and of the stored definitions that do not change are pointed
+ * at instead of copied.
+ *
+ * @param variables : table of the trees assigned to the variables
+ * @param arena : arena for the nodes that change, a new one is created if
+ * it is null
+ * @return AST : returned simplified AST
+ */
+AST AST::simplifyTree(SymbolTable &variables, shared_ptr<Arena> arena)
+{
+   AST newAST = AST(move(arena));
+   if (newAST.arena_ == nullptr)
+   {
+      newAST.arena_ = make_shared<Arena>();
+   }
+   Expanding expanding;
+   Sharing sharing(*newAST.arena_, expanding);
+   newAST.borrow(arena_);
+   newAST.root_ = newAST.simplifyShared(root_, variables, sharing);
+   return newAST;
+}
+
+/**
+ * @brief evaluate
+ * this method evaluates the tree with its bytecode. The bytecode is
+ * compiled the first time and reused after that. Each variable is bound to
+ * the value of the AST stored for it, which must not have variables itself
+ * unless the value kept for it is a number.
+ *
+ * @param variables : table of the trees assigned to the variables
+ * @param value : value of the expression
+ * @return true : if the tree evaluates to an int64_t
+ * @return false : if a variable has no value or a calculation cannot be
+ * done exactly on machine integers
+ */
+bool AST::evaluate(SymbolTable &variables, int64_t &value) const
+{
+   if (root_ == nullptr)
+   {
+      return false;
+   }
+   if (code_ == nullptr)
+   {
+      code_ = make_shared<Bytecode>(*this);
+   }
+   return runCode(*code_, variables, value);
+}
+
+/**
+ * @brief evaluate
+ * same as above but compiles the tree into the given bytecode instead of
+ * keeping code of its own. This is for a tree that is evaluated once, the
+ * bytecode is reused for the next tree and only allocates when a tree is
+ * bigger than the ones before.
+ *
+ * @param variables : table of the trees assigned to the variables
+ * @param value : value of the expression
+ * @param scratch : bytecode the tree is compiled into
+ * @return true : if the tree evaluates to an int64_t
+ * @return false : if a variable has no value or a calculation cannot be
+ * done exactly on machine integers
+ */
+bool AST::evaluate(SymbolTable &variables, int64_t &value,
+                   Bytecode &scratch) const
+{
+   if (root_ == nullptr)
+   {
+      return false;
+   }
+   scratch.compile(*this);
+   return runCode(scratch, variables, value);
+}
+
+/**
+ * @brief runCode
+ * this method runs the compiled code of the tree. Each variable is bound
+ * to the value of the AST stored for it.
+ *
+ * @param code : code compiled from this tree
+ * @param variables : table of the trees assigned to the variables
+ * @param value : value of the expression
+ * @return true : if the tree evaluates to an int64_t
+ * @return false : if a variable has no value or a calculation cannot be
+ * done exactly on machine integers
+ */
+bool AST::runCode(const Bytecode &code, SymbolTable &variables,
+                  int64_t &value) const
+{
+   if (!code.valid())
+   {
+      return false;
+   }
+
+   // the values of the slots, on the stack for the usual few variables
+   const vector<uint32_t> &ids = code.variables();
+   int64_t fewValues[8];
+   vector<int64_t> manyValues;
+   int64_t *values = fewValues;
+   if (ids.size() > 8)
+   {
+      manyValues.resize(ids.size());
+      values = manyValues.data();
+   }
+   for (int i = 0; i < ids.size(); i++)
+   {
+      const AST *found = variables.find(ids[i]);
+      if (found == nullptr)
+      {
+         return false;
+      }
+      // a stored tree that has variables of its own is left to
+      // simplifyTree, which substitutes them as well
+      const AST &stored = *found;
+      if (stored.value_ != nullptr &&
+          stored.value_->root_->token.type_ == number &&
+          stored.value_->root_->big == nullptr)
+      {
+         values[i] = stored.value_->root_->token.number_;
+         continue;
+      }
+      if (stored.root_ == nullptr || stored.root_->token.type_ == variable)
+      {
+         return false;
+      }
+      if (stored.code_ == nullptr)
+      {
+         stored.code_ = make_shared<Bytecode>(stored);
+      }
+      if (!stored.code_->valid() || !stored.code_->variables().empty() ||
+          !stored.code_->run(nullptr, values[i]))
+      {
+         return false;
+      }
+   }
+   return code.run(values, value);
+}
+
+/**
+ * @brief operator==
+ *
+ * @param rhs : key to compare with
+ * @return true : if both keys describe the same node
+ * @return false : if they do not
+ */
+bool AST::NodeKey::operator==(const NodeKey &rhs) const
+{
+   return type == rhs.type && op == rhs.op && id == rhs.id &&
+          number == rhs.number && big == rhs.big && left == rhs.left &&
+          right == rhs.right;
+}
+
+/**
+ * @brief find
+ * this function finds the slot of a key. A new key gets a slot whose node is
+ * nullptr and the caller fills it in before the next find.
+ *
+ * @param key : key of a node
+ * @return Node*& : the node of the slot
+ */
+AST::Node *&AST::Sharing::find(const NodeKey &key)
+{
+   if ((used + 1) * 2 > capacity)
+   {
+      // keep the table at most half full so probes stay short, the old
+      // table stays in the arena until it is released
+      Slot *old = slots;
+      size_t oldCapacity = capacity;
+      capacity = capacity < 16 ? 16 : capacity * 2;
+      slots = static_cast<Slot *>(
+          arena.allocate(capacity * sizeof(Slot), alignof(Slot)));
+      for (size_t i = 0; i < capacity; i++)
+      {
+         slots[i].node = nullptr;
+      }
+      used = 0;
+      for (size_t i = 0; i < oldCapacity; i++)
+      {
+         if (old[i].node != nullptr)
+         {
+            find(old[i].key) = old[i].node;
+         }
+      }
+   }
+
+   // the children are arena addresses that differ only in a few middle
+   // bits, so the sum is mixed before its low bits pick the slot
+   uint64_t h = uint64_t(key.number) + (uint64_t(key.type) << 8 | key.op) +
+                (uint64_t(key.id) << 16) + uint64_t(key.big);
+   h = (h ^ uint64_t(key.left)) * 0x9e3779b97f4a7c15ULL;
+   h = (h ^ uint64_t(key.right)) * 0x9e3779b97f4a7c15ULL;
+   h ^= h >> 29;
+   size_t mask = capacity - 1;
+   for (size_t i = h & mask;; i = (i + 1) & mask)
+   {
+      if (slots[i].node == nullptr)
+      {
+         slots[i].key = key;
+         used++;
+         return slots[i].node;
+      }
+      if (slots[i].key == key)
+      {
+         return slots[i].node;
+      }
+   }
+}
+
+/**
+ * @brief keyOf
+ *
+ * @param t : token of the node
+ * @param big : value of a big number, nullptr otherwise
+ * @param left : shared left node
+ * @param right : shared right node
+ * @return NodeKey : key of the node
+ */
+AST::NodeKey AST::keyOf(const Token &t, const Rational *big,
+                        const Node *left, const Node *right)
+{
+   // only the member of the union that the token holds is read, a big number
+   // is told apart by big
+   NodeKey key = {t.type_, t.op_, t.type_ == variable ? t.id_ : 0,
+                  t.type_ == number ? t.number_ : 0, big, left, right};
+   return key;
+}
+
+/**
+ * @brief share
+ * this function looks a new node up in the table of shared nodes
+ * PRE: the children of the node are shared already
+ *
+ * @param sharing : state of the simplification
+ * @param node : node that was just made in the arena of the tree
+ * @return Node* : the node that was there first, or node if it is new
+ */
+AST::Node *AST::share(Sharing &sharing, Node *node)
+{
+   Node *&slot =
+       sharing.find(keyOf(node->token, node->big, node->left, node->right));
+   if (slot == nullptr)
+   {
+      slot = node;
+   }
+   // a node that was there first leaves this one in the arena until it is
+   // released
+   return slot;
+}
+
+/**
+ * @brief simplifyShared
+ * this function substitutes the variables of a subtree and rewrites every
+ * operator by the rules of combine(). A variable is resolved through the
+ * table of variables when the walk reaches it, and its definition is
+ * simplified the same way, so the variables it refers to are substituted
+ * as well. Only the nodes that change are made, in the arena of this tree
+ * and shared through the table. A subtree that does not change is used as
+ * it is and its arena is kept alive by this tree.
+ * The walk keeps its own stack of steps. A definition that has to be
+ * simplified is pushed on the same stack with the tree it is simplified
+ * into, so neither a deep tree nor a long chain of definitions recurses.
+ *
+ * @param source : node of this tree or of a stored definition
+ * @param variables : table of the trees assigned to the variables
+ * @param sharing : state of the simplification
+ * @return Node* : the simplified subtree
+ */
+AST::Node *AST::simplifyShared(Node *source, SymbolTable &variables,
+                               Sharing &sharing)
+{
+   if (source == nullptr)
+   {
+      return nullptr;
+   }
+
+   // the stacks are kept from one call to the next, so a walk only
+   // allocates for a tree deeper than the ones before
+   static thread_local vector<Step> steps;
+   static thread_local vector<Node *> results;
+   vector<Expansion> expansions;
+   steps.clear();
+   results.clear();
+
+   steps.push_back(Step{source, visitStep});
+   while (!steps.empty())
+   {
+      Step step = steps.back();
+      steps.pop_back();
+      Node *node = step.source;
+      Node *result;
+      if (step.kind == defineStep)
+      {
+         // the definition is done, the tree below it on the stack uses it
+         expansions.back().value->root_ = results.back();
+         results.pop_back();
+         sharing.expanding.pop();
+         size_t below = expansions.size() - 1;
+         AST &tree = below == 0 ? *this : *expansions[below - 1].value;
+         Sharing &state = below == 0 ? sharing
+                                     : expansions[below - 1].sharing;
+         result = tree.define(expansions.back(), state, variables);
+         expansions.pop_back();
+      }
+      else
+      {
+         // the tree being built and the state of its simplification
+         AST &tree = expansions.empty() ? *this : *expansions.back().value;
+         Sharing &state = expansions.empty() ? sharing
+                                             : expansions.back().sharing;
+         if (step.kind == combineStep)
+         {
+            Node *right = results.back();
+            results.pop_back();
+            Node *left = results.back();
+            results.pop_back();
+            results.push_back(tree.combine(node, left, right, state));
+            continue;
+         }
+         if (isOperator(node->token) || isPower(node->token))
+         {
+            steps.push_back(Step{node, combineStep});
+            steps.push_back(Step{node->right, visitStep});
+            steps.push_back(Step{node->left, visitStep});
+            continue;
+         }
+         if (!isVariable(node->token))
+         {
+            results.push_back(node);
+            continue;
+         }
+         result = tree.substitute(node, variables, state);
+         if (result == nullptr)
+         {
+            // the definition is simplified into a tree of its own before
+            // the walk goes on, so the value outlives the arena of this tree
+            uint32_t id = node->token.id_;
+            size_t depth = sharing.expanding.size();
+            sharing.expanding.push(id);
+            AST &stored = *variables.find(id);
+            expansions.push_back(
+                Expansion(id, stored, depth, sharing.expanding));
+            steps.push_back(Step{node, defineStep});
+            steps.push_back(Step{stored.root_, visitStep});
+            continue;
+         }
+      }
+      if (result->token.type_ == variable &&
+          result->token.id_ == node->token.id_)
+      {
+         // a variable that stands for itself is not a change
+         result = node;
+      }
+      results.push_back(result);
+   }
+   return results.back();
+}
+
+/**
+ * @brief combine
+ * this function makes the simplified operator of two simplified operands.
+ * The rules of the simplification are applied to it, so an operator whose
+ * operands are numbers is folded if the calculation can be done exactly
+ * and x*1 or 2*x+3*x become x and 5*x. An operator whose operands did not
+ * change and that no rule applies to is the source itself.
+ *
+ * @param source : operator node of this tree or of a stored definition
+ * @param left : simplified left operand
+ * @param right : simplified right operand
+ * @param sharing : state of the simplification
+ * @return Node* : the simplified operator, source if nothing changed
+ */
+AST::Node *AST::combine(Node *source, Node *left, Node *right,
+                        Sharing &sharing)
+{
+   bool numbers = left->token.type_ == number &&
+                  right->token.type_ == number;
+   Rewrite step(source->token, left, right);
+   if (!numbers && left == source->left && right == source->right)
+   {
+      if (!rewrite(step, sharing))
+      {
+         return source;
+      }
+      return build(step, sharing);
+   }
+   NodeKey key = keyOf(source->token, nullptr, left, right);
+   Node *done = sharing.find(key);
+   if (done != nullptr)
+   {
+      return done;
+   }
+
+   // a calculation that cannot be done exactly is left in the tree, and
+   // the operator keeps the result either way
+   rewrite(step, sharing);
+   Node *node = build(step, sharing);
+   sharing.find(key) = node;
+   return node;
+}
+
+/**
+ * @brief rewrite
+ * this function applies the rules of the simplification to an operator
+ * until none applies. The operands are simplified already, so only the
+ * operator that a rule made can match another rule, and it is rewritten
+ * again right away instead of walking the whole tree again.
+ *
+ * @param step : the operator, it receives the result
+ * @param sharing : state of the simplification
+ * @return true : if a rule changed the operator
+ * @return false : if no rule applies, nothing is made
+ */
+bool AST::rewrite(Rewrite &step, Sharing &sharing)
+{
+   bool changed = false;
+   while (step.node == nullptr && rule(step, sharing))
+   {
+      changed = true;
+   }
+   return changed;
+}
+
+/**
+ * @brief rule
+ * this function applies the first rule that matches an operator: folding
+ * numbers, removing an operand that is 0 or 1, collecting like terms
+ * such as 2*x+3*x and gathering the numbers of (x+2)+3 or 2*(3*x)
+ *
+ * @param step : the operator, it receives the result
+ * @param sharing : state of the simplification
+ * @return true : if a rule applied
+ * @return false : if none did
+ */
+bool AST::rule(Rewrite &step, Sharing &sharing)
+{
+   Node *left = step.left;
+   Node *right = step.right;
+   Opcode op = step.token.op_;
+   bool leftNumber = left->token.type_ == number;
+   bool rightNumber = right->token.type_ == number;
+   if (leftNumber && rightNumber)
+   {
+      step.node = fold(op, left, right, sharing);
+      return step.node != nullptr;
+   }
+
+   Node *base;
+   Node *offset;
+   Node *coefficient;
+   switch (op)
+   {
+   case opAdd:
+   case opSub:
+   {
+      if (isValue(right, 0))
+      {
+         step.node = left;
+         return true;
+      }
+      if (op == opAdd && isValue(left, 0))
+      {
+         step.node = right;
+         return true;
+      }
+      if (isNegative(right))
+      {
+         // x+-3 is x-3 and x--3 is x+3
+         step = Rewrite(Token(binop, op == opAdd ? opSub : opAdd), left,
+                        fold(opSub, numberNode(0, sharing), right, sharing));
+         return true;
+      }
+      if (rightNumber && (offset = offsetOf(left, base, sharing)) != nullptr)
+      {
+         // (x+2)+3 is x+5 and (x+2)-3 is x-1
+         sum(step, base, fold(op, offset, right, sharing), sharing);
+         return true;
+      }
+      if (op == opAdd && leftNumber &&
+          (offset = offsetOf(right, base, sharing)) != nullptr)
+      {
+         // 3+(x+2) is x+5
+         sum(step, base, fold(opAdd, left, offset, sharing), sharing);
+         return true;
+      }
+      if (op == opSub && isValue(left, 0) &&
+          (coefficient = coefficientOf(right, base, sharing)) != nullptr)
+      {
+         // 0-2*x is -2*x and 0-(0-x) is x
+         step = Rewrite(Token(binop, opMul),
+                        fold(opSub, left, coefficient, sharing), base);
+         return true;
+      }
+      if (leftNumber || rightNumber)
+      {
+         return false;
+      }
+      // 2*x+3*x is 5*x, x-x is 0*x, which is 0, and x-2*x is -1*x, which
+      // is 0-x
+      Node *otherBase;
+      Node *other = coefficientOf(right, otherBase, sharing);
+      coefficient = coefficientOf(left, base, sharing);
+      if (!sameTree(base, otherBase))
+      {
+         return false;
+      }
+      Node *one = numberNode(1, sharing);
+      Node *sum = fold(op, coefficient != nullptr ? coefficient : one,
+                       other != nullptr ? other : one, sharing);
+      if (isValue(sum, 0) && dividesByZero(base))
+      {
+         // (x/0)-(x/0) keeps the division that could not be done
+         return false;
+      }
+      step = Rewrite(Token(binop, opMul), sum, base);
+      return true;
+   }
+   case opMul:
+      if ((isValue(left, 0) && !dividesByZero(right)) || isValue(right, 1))
+      {
+         step.node = left;
+         return true;
+      }
+      if ((isValue(right, 0) && !dividesByZero(left)) || isValue(left, 1))
+      {
+         step.node = right;
+         return true;
+      }
+      // 2*(3*x) is 6*x
+      coefficient = leftNumber || rightNumber
+                        ? coefficientOf(leftNumber ? right : left, base,
+                                        sharing)
+                        : nullptr;
+      if (coefficient != nullptr)
+      {
+         step = Rewrite(step.token,
+                        fold(opMul, leftNumber ? left : right, coefficient,
+                             sharing),
+                        base);
+         return true;
+      }
+      if (isValue(left, -1) || isValue(right, -1))
+      {
+         // -1*x is 0-x
+         step = Rewrite(Token(binop, opSub), numberNode(0, sharing),
+                        rightNumber ? left : right);
+         return true;
+      }
+      return false;
+   case opDiv:
+      if (isValue(right, 1))
+      {
+         step.node = left;
+         return true;
+      }
+      return false;
+   case opPow:
+      if (isValue(right, 1))
+      {
+         step.node = left;
+         return true;
+      }
+      if (isValue(right, 0) && !dividesByZero(left))
+      {
+         step.node = numberNode(1, sharing);
+         return true;
+      }
+      return false;
+   default:
+      return false;
+   }
+}
+
+/**
+ * @brief build
+ * this function makes the node of an operator that was rewritten, or
+ * finds the one that was made before
+ *
+ * @param step : the rewritten operator
+ * @param sharing : state of the simplification
+ * @return Node* : the node of the result
+ */
+AST::Node *AST::build(const Rewrite &step, Sharing &sharing)
+{
+   if (step.node != nullptr)
+   {
+      return step.node;
+   }
+   Node *&slot =
+       sharing.find(keyOf(step.token, nullptr, step.left, step.right));
+   if (slot == nullptr)
+   {
+      slot = makeNode(step.token, step.left, step.right);
+   }
+   return slot;
+}
+
+/**
+ * @brief fold
+ * this function calculates an operator whose operands are numbers
+ *
+ * @param op : the operation
+ * @param left : left number
+ * @param right : right number
+ * @param sharing : state of the simplification
+ * @return Node* : number node of the result, nullptr if the calculation
+ * cannot be done exactly
+ */
+AST::Node *AST::fold(Opcode op, Node *left, Node *right, Sharing &sharing)
+{
+   Node *node = makeNode(Token(op == opPow ? powop : binop, op), left, right);
+   int64_t solution;
+   if (left->big == nullptr && right->big == nullptr &&
+       calc(left->token.number_, op, right->token.number_, solution))
+   {
+      node->token = Token::fromNumber(solution);
+   }
+   else if (!foldExact(node))
+   {
+      return nullptr;
+   }
+   node->left = nullptr;
+   node->right = nullptr;
+   return share(sharing, node);
+}
+
+/**
+ * @brief numberNode
+ *
+ * @param value : value of the number
+ * @param sharing : state of the simplification
+ * @return Node* : shared number node of the value
+ */
+AST::Node *AST::numberNode(int64_t value, Sharing &sharing)
+{
+   Token t = Token::fromNumber(value);
+   Node *&slot = sharing.find(keyOf(t, nullptr, nullptr, nullptr));
+   if (slot == nullptr)
+   {
+      slot = makeNode(t);
+   }
+   return slot;
+}
+
+/**
+ * @brief sum
+ * this function sets an operator to base plus a number. A number that is
+ * 0 leaves the base and a negative number is subtracted instead.
+ *
+ * @param step : the operator, it receives the result
+ * @param base : the operand that is not a number
+ * @param offset : the number
+ * @param sharing : state of the simplification
+ */
+void AST::sum(Rewrite &step, Node *base, Node *offset, Sharing &sharing)
+{
+   if (isValue(offset, 0))
+   {
+      step.node = base;
+   }
+   else if (isNegative(offset))
+   {
+      step = Rewrite(Token(binop, opSub), base,
+                     fold(opSub, numberNode(0, sharing), offset, sharing));
+   }
+   else
+   {
+      step = Rewrite(Token(binop, opAdd), base, offset);
+   }
+}
+
+/**
+ * @brief offsetOf
+ * this function splits x+k, k+x and x-k into x and the number added to
+ * it
+ *
+ * @param node : a simplified node
+ * @param base : receives x
+ * @param sharing : state of the simplification
+ * @return Node* : the number added to x, negated for x-k, nullptr if the
+ * node is not a sum of a number
+ */
+AST::Node *AST::offsetOf(Node *node, Node *&base, Sharing &sharing)
 {
-   root_ = new Node(t);
+   if (node->token.type_ != binop)
+   {
+      return nullptr;
+   }
+   bool leftNumber = node->left->token.type_ == number;
+   bool rightNumber = node->right->token.type_ == number;
+   if (leftNumber == rightNumber)
+   {
+      return nullptr;
+   }
+   if (node->token.op_ == opAdd)
+   {
+      base = leftNumber ? node->right : node->left;
+      return leftNumber ? node->left : node->right;
+   }
+   if (node->token.op_ == opSub && rightNumber)
+   {
+      base = node->left;
+      return fold(opSub, numberNode(0, sharing), node->right, sharing);
+   }
+   return nullptr;
 }
 
 /**
- * @brief Construct a new AST object
- * copy constructor that calls copyTree()
+ * @brief coefficientOf
+ * this function splits k*x, x*k and 0-x into x and the number it is
+ * multiplied by
  *
- * @param ast
+ * @param node : a simplified node that is not a number
+ * @param base : receives x, the node itself if it is not such a product
+ * @param sharing : state of the simplification
+ * @return Node* : the number x is multiplied by, nullptr for 1
  */
-AST::AST(const AST &ast) 
+AST::Node *AST::coefficientOf(Node *node, Node *&base, Sharing &sharing)
 {
-   root_ = copyTree(ast.root_);
+   base = node;
+   if (node->token.type_ != binop)
+   {
+      return nullptr;
+   }
+   bool leftNumber = node->left->token.type_ == number;
+   bool rightNumber = node->right->token.type_ == number;
+   if (leftNumber == rightNumber)
+   {
+      return nullptr;
+   }
+   if (node->token.op_ == opSub && isValue(node->left, 0))
+   {
+      base = node->right;
+      return numberNode(-1, sharing);
+   }
+   if (node->token.op_ != opMul)
+   {
+      return nullptr;
+   }
+   base = leftNumber ? node->right : node->left;
+   return leftNumber ? node->left : node->right;
 }
 
 /**
- * @brief operator=
- * this is an assignment operator that assigns the ast passed in
+ * @brief sameTree
+ * this function compares two subtrees node by node with a stack. Shared
+ * subtrees compare at once by address. A comparison that looks at more
+ * than a fixed number of nodes gives up, so the rules never make the
+ * simplification quadratic.
  *
- * @param ast : AST that will be assigned
- * @return AST& : new AST
+ * @param a : first subtree
+ * @param b : second subtree
+ * @return true : if they are known to be the same expression
+ * @return false : if they differ or the comparison gave up
  */
-AST &AST::operator=(const AST &ast)
+bool AST::sameTree(const Node *a, const Node *b)
 {
-   if (&ast != this) //check for self assignment
+   // most pairs of nodes looked at before giving up
+   const size_t budget = 1024;
+
+   // the stack is kept from one call to the next
+   static thread_local vector<pair<const Node *, const Node *> > pairs;
+   pairs.clear();
+   pairs.push_back(make_pair(a, b));
+   size_t looked = 0;
+   while (!pairs.empty())
    {
-      clear(root_);
-      root_ = copyTree(ast.root_);
-   }                          
-   return *this;
+      const Node *x = pairs.back().first;
+      const Node *y = pairs.back().second;
+      pairs.pop_back();
+      if (x == y)
+      {
+         continue;
+      }
+      if (x == nullptr || y == nullptr || ++looked > budget ||
+          x->token.type_ != y->token.type_ || x->token.op_ != y->token.op_)
+      {
+         return false;
+      }
+      if (x->token.type_ == variable)
+      {
+         if (x->token.id_ != y->token.id_)
+         {
+            return false;
+         }
+      }
+      else if (x->token.type_ == number)
+      {
+         if ((x->big == nullptr) != (y->big == nullptr) ||
+             (x->big == nullptr ? x->token.number_ != y->token.number_
+                                : !(*x->big - *y->big).isZero()))
+         {
+            return false;
+         }
+      }
+      else
+      {
+         pairs.push_back(make_pair(x->right, y->right));
+         pairs.push_back(make_pair(x->left, y->left));
+      }
+   }
+   return true;
 }
 
 /**
- * @brief Destroy the AST object
+ * @brief dividesByZero
+ * this function looks for a division by 0 that was left in a subtree
+ * because it cannot be done, such as 1/0 or 0^-1. A rule that would
+ * remove the subtree, like x*0 is 0, does not apply to it, so the
+ * division is still seen. The walk gives up after a fixed number of nodes
+ * and then answers true, which only keeps a larger tree.
  *
+ * @param node : a simplified subtree
+ * @return true : if the subtree may divide by 0
+ * @return false : if it does not
  */
-AST::~AST()
+bool AST::dividesByZero(const Node *node)
 {
-   clear(root_);
+   // most nodes looked at before giving up
+   const size_t budget = 4096;
+
+   // the stack is kept from one call to the next
+   static thread_local vector<const Node *> walk;
+   walk.clear();
+   walk.push_back(node);
+   size_t looked = 0;
+   while (!walk.empty())
+   {
+      const Node *top = walk.back();
+      walk.pop_back();
+      if (top->left == nullptr)
+      {
+         continue;
+      }
+      if (++looked > budget)
+      {
+         return true;
+      }
+      const Token &t = top->token;
+      if ((t.op_ == opDiv && isValue(top->right, 0)) ||
+          (t.op_ == opPow && isValue(top->left, 0) && isNegative(top->right)))
+      {
+         return true;
+      }
+      walk.push_back(top->right);
+      walk.push_back(top->left);
+   }
+   return false;
 }
 
 /**
- * @brief clear
- * this function takes in a root and clears the entire tree
+ * @brief isValue
+ *
+ * @param node : a node
+ * @param value : a small integer
+ * @return true : if the node is a number with the value
+ * @return false : if not
+ */
+bool AST::isValue(const Node *node, int64_t value)
+{
+   return node->token.type_ == number && node->big == nullptr &&
+          node->token.number_ == value;
+}
+
+/**
+ * @brief isNegative
  *
- * @param root
+ * @param node : a node
+ * @return true : if the node is a number less than 0
+ * @return false : if not
  */
-void AST::clear(Node* &root)
+bool AST::isNegative(const Node *node)
 {
-   if (root == nullptr)
+   if (node->token.type_ != number)
    {
-      return;
+      return false;
    }
-   clear(root->left);
-   clear(root->right);
-
-   delete root;
-   root = nullptr;
+   return node->big != nullptr ? node->big->isNegative()
+                               : node->token.number_ < 0;
 }
 
 /**
- * @brief copyTree
- * this function takes in the root of the tree to be copied and copies
- * the tree. It then returns the new node of the copy.
+ * @brief substitute
+ * this function finds the simplified value of a variable. A stored tree
+ * keeps its value, so it is only simplified again after one of the
+ * variables it depends on is assigned. A definition that has no value yet
+ * is left to the caller, which simplifies it and calls define().
  *
- * @param oldRoot : root of tree to be copied
- * @return Node* : new tree root
+ * @param source : variable node
+ * @param variables : table of the trees assigned to the variables
+ * @param sharing : state of the simplification
+ * @return Node* : value of the variable, source if it has none, nullptr if
+ * its definition has to be simplified first
  */
-AST::Node *AST::copyTree(const Node *oldRoot) const
+AST::Node *AST::substitute(Node *source, SymbolTable &variables,
+                           Sharing &sharing)
 {
-   //check if oldRoot is nullptr
-   Node *newRoot = new Node(oldRoot->token);
-   if (oldRoot->left != nullptr)
+   uint32_t id = source->token.id_;
+   if (sharing.tracking)
+   {
+      sharing.dependencies.push_back(id);
+   }
+   AST *found = variables.find(id);
+   if (found == nullptr)
+   {
+      return source;
+   }
+   AST &stored = *found;
+   if (stored.value_ != nullptr)
+   {
+      // the value is dropped when what it depends on changes, so naming the
+      // variable is the only dependency
+      const Node *value = stored.value_->root_;
+      if (value->left == nullptr && value->big == nullptr)
+      {
+         // a value that is one node is made again in this tree, which is
+         // cheaper than keeping the arena of the value alive. A big number
+         // lives in that arena, so it is borrowed like a larger value.
+         Node *&slot = sharing.find(keyOf(value->token, nullptr, nullptr,
+                                          nullptr));
+         if (slot == nullptr)
+         {
+            slot = makeNode(value->token);
+         }
+         return slot;
+      }
+      borrow(stored.value_);
+      return stored.value_->root_;
+   }
+   if (stored.root_->left == nullptr && stored.root_->token.type_ == variable &&
+       stored.root_->token.id_ == id)
+   {
+      // the variable stands for itself
+      return source;
+   }
+   size_t depth = sharing.expanding.depth(id);
+   if (depth != SIZE_MAX)
    {
-      newRoot->left = copyTree(oldRoot->left);
+      // a variable that is defined in terms of itself stays a variable
+      sharing.cycle = depth < sharing.cycle ? depth : sharing.cycle;
+      return source;
    }
-   if (oldRoot->right != nullptr)
+   unordered_map<uint32_t, Node *>::iterator def =
+       sharing.definitions.find(id);
+   if (def != sharing.definitions.end())
    {
-      newRoot->right = copyTree(oldRoot->right);
+      return def->second;
    }
-   return newRoot;
+   return nullptr;
 }
 
 /**
- * @brief constructTree
- * this function takes in a postfix vector of tokens and creates an AST,
- * setting the root_ member variable to the root
+ * @brief define
+ * this function uses a definition that was just simplified for its
+ * variable. The value is kept for the stored tree, so it is only simplified
+ * again after one of the variables it depends on is assigned. A value that
+ * depends on where the variable was reached, because its definition refers
+ * back to a variable being substituted, is not kept, and what it depends
+ * on becomes a dependency of this tree instead.
  *
- * @param postfix : vector of tokens in postfix form
+ * @param expansion : the finished definition
+ * @param sharing : state of the simplification of this tree
+ * @param variables : table of the trees assigned to the variables
+ * @return Node* : value of the variable
  */
-void AST::constructTree(vector<Token> &postfix)
+AST::Node *AST::define(Expansion &expansion, Sharing &sharing,
+                       SymbolTable &variables)
 {
-   stack<Node *> stack;
+   AST &stored = *expansion.stored;
+   Sharing &inner = expansion.sharing;
+   expansion.value->borrow(stored.arena_);
+   borrow(expansion.value);
 
-   for (int i = 0; i < postfix.size(); i++)
+   sort(inner.dependencies.begin(), inner.dependencies.end());
+   inner.dependencies.erase(unique(inner.dependencies.begin(),
+                                   inner.dependencies.end()),
+                            inner.dependencies.end());
+   if (inner.cycle != SIZE_MAX)
    {
-      if (isOperator(postfix[i]) || isPower(postfix[i]))
+      // the value is only right for this simplification. A variable of a
+      // cycle is left as it is where the cycle is first reached, so which
+      // variable that is depends on the order the cycle is walked in. Only
+      // a cycle through a variable below this one changes the value of the
+      // tree below it.
+      if (inner.cycle < expansion.depth)
       {
-
-         Node *left = stack.top();
-         stack.pop();
-
-         Node *right = stack.top();
-         stack.pop();
-
-         // construct a new binary tree whose root is the operator and whose
-         // left and right children point to `y` and `x`
-         Node *node = new Node(postfix[i], left, right);
-
-         // push the current node into the stack
-         stack.push(node);
+         sharing.cycle = inner.cycle < sharing.cycle ? inner.cycle
+                                                     : sharing.cycle;
       }
-      else if (isOperand(postfix[i]))
+      sharing.definitions[expansion.id] = expansion.value->root_;
+      if (sharing.tracking)
       {
-         // if number or variable, push onto stack
-         stack.push(new Node(postfix[i]));
+         sharing.dependencies.insert(sharing.dependencies.end(),
+                                     inner.dependencies.begin(),
+                                     inner.dependencies.end());
       }
    }
-   // set root to point to tree
-   root_ = stack.top();
+   else
+   {
+      stored.value_ = expansion.value;
+      stored.dependencies_ = move(inner.dependencies);
+      variables.keep(expansion.id, stored.dependencies_);
+   }
+   return expansion.value->root_;
 }
 
 /**
- * @brief simplify
- * this method takes in the map of variables and creates a copy of the
- * current AST. It then calles fillVariables and traverseAndSimplify on
- * the copy and returns the simplifed copy
- * @param variables: an array that holds the variables that can be stored
- * @return AST : returned simplified AST
+ * @brief borrow
+ * this function keeps the arena of another tree alive as long as this tree
+ * is, because nodes of this tree may point into it
+ *
+ * @param arena : arena of the other tree
  */
-AST AST::simplify(map<string, AST> &variables)
+void AST::borrow(const shared_ptr<Arena> &arena)
 {
-   // make a copy called newAST
-   AST newAST = AST(*this);
-
-   // modify tree to include variable expressions from the map
-   newAST.fillVariables(variables);
-   // return the simplified tree
-   newAST.traverseAndSimplify();
-   return newAST;
+   if (arena == nullptr || arena == arena_ ||
+       find(borrowed_.begin(), borrowed_.end(), arena) != borrowed_.end())
+   {
+      return;
+   }
+   borrowed_.push_back(arena);
 }
 
 /**
- * @brief fillVariables
- * this functions calls fillVariablesHelper, which is a recursive method
+ * @brief borrow
+ * same as above for the value of a stored tree, which keeps alive every
+ * arena it points into
  *
- * @param variables : map of variables with an associated AST
+ * @param value : the value
  */
-void AST::fillVariables(map<string, AST> &variables)
+void AST::borrow(const shared_ptr<const AST> &value)
 {
-   root_ = fillVariablesHelper(root_, variables);
+   if (find(borrowedValues_.begin(), borrowedValues_.end(), value) !=
+       borrowedValues_.end())
+   {
+      return;
+   }
+   borrowedValues_.push_back(value);
 }
 
 /**
- * @brief traverseAndSimplify
- * this function calls the recursive travserse and simplify helper function
+ * @brief invalidate
+ * this method drops the value kept for a stored tree if it depends on the
+ * given variable, it is called when the variable is assigned or its own
+ * value is dropped
  *
+ * @param id : interned id of the variable that changed
+ * @return true : if the value was dropped
+ * @return false : if there was no value or it does not depend on id
  */
-void AST::traverseAndSimplify()
+bool AST::invalidate(uint32_t id)
 {
-   traverseAndSimplifyHelper(root_);
+   if (value_ != nullptr &&
+       binary_search(dependencies_.begin(), dependencies_.end(), id))
+   {
+      value_.reset();
+      dependencies_.clear();
+      return true;
+   }
+   return false;
 }
 
 /**
- * @brief fillVariablesHelper
- * this functions takes in a map of variables and fills the variables that are
- * in the current AST with the AST that is stored for that variable. The
- * function takes in a root pointer and the map of variables
+ * @brief calc
+ * this function takes in two operands and an operator and performs
+ * the correct calculation on machine integers
  *
- * @param root : node pointer
- * @param variables : map of variables
- * @return Node* : node pointer
+ * @param leftOperand : operand that is left child
+ * @param binop : operator
+ * @param rightOperand : operand that is right child
+ * @param solution : result of calculation
+ * @return true : if the result is an exact integer
+ * @return false : if the calculation overflows, divides by zero or the
+ * result is a fraction
  */
-AST::Node *AST::fillVariablesHelper(Node *&root, map<string, AST> &variables)
+bool AST::calc(int64_t leftOperand, Opcode binop, int64_t rightOperand,
+               int64_t &solution)
 {
-   if (root == nullptr)
+   if (binop == opAdd)
    {
-      return root;
+      return !__builtin_add_overflow(leftOperand, rightOperand, &solution);
+   }
+   else if (binop == opSub)
+   {
+      return !__builtin_sub_overflow(leftOperand, rightOperand, &solution);
+   }
+   else if (binop == opMul)
+   {
+      return !__builtin_mul_overflow(leftOperand, rightOperand, &solution);
+   }
+   else if (binop == opDiv)
+   {
+      if (rightOperand == 0 || (leftOperand == INT64_MIN && rightOperand == -1) ||
+          leftOperand % rightOperand != 0)
+      {
+         return false;
+      }
+      solution = leftOperand / rightOperand;
+      return true;
    }
 
-   root->left = fillVariablesHelper(root->left, variables);
-   root->right = fillVariablesHelper(root->right, variables);
-
-   if (isVariable(root->token))
+   // power by squaring
+   int64_t base = leftOperand;
+   int64_t exponent = rightOperand;
+   if (exponent < 0)
+   {
+      if (base != 1 && base != -1)
+      {
+         return false;
+      }
+      solution = (exponent & 1) ? base : 1;
+      return true;
+   }
+   solution = 1;
+   while (exponent > 0)
    {
-      // store variable string in var
-      string var = root->token.value_;
-      // get the root of the ast via the var and copy the variable ast to
-      // where the root is of the variable in the AST
-      // do i have to check if the root of variable is left and right nullptr?
-      root = copyTree(variables[var].root_);
+      if ((exponent & 1) && __builtin_mul_overflow(solution, base, &solution))
+      {
+         return false;
+      }
+      exponent >>= 1;
+      if (exponent > 0 && __builtin_mul_overflow(base, base, &base))
+      {
+         return false;
+      }
    }
-   return root;
+   return true;
 }
 
 /**
- * @brief traverseAndSimplifyHelper
- * this function takes in a node pointer and traverses the tree calling calc()
- * wherever an expression can be simplified
+ * @brief calc
+ * same as above on arbitrary precision integers, used when an operand or
+ * the result does not fit in an int64_t
  *
- * @param root : node pointer
+ * @param leftOperand : operand that is left child
+ * @param binop : operator
+ * @param rightOperand : operand that is right child
+ * @param solution : result of calculation
+ * @return true : if the result is an exact integer
+ * @return false : if the calculation divides by zero, the result is a
+ * fraction or the power is too large to compute
  */
-void AST::traverseAndSimplifyHelper(Node *&root)
+bool AST::calc(const BigInt &leftOperand, Opcode binop,
+               const BigInt &rightOperand, BigInt &solution)
 {
-   if (root == nullptr)
+   // largest power that is folded, in bits of the result
+   const size_t maxPowerBits = size_t(1) << 20;
+
+   if (binop == opAdd)
    {
-      return;
+      solution = leftOperand + rightOperand;
+      return true;
+   }
+   else if (binop == opSub)
+   {
+      solution = leftOperand - rightOperand;
+      return true;
+   }
+   else if (binop == opMul)
+   {
+      solution = leftOperand * rightOperand;
+      return true;
+   }
+   else if (binop == opDiv)
+   {
+      BigInt remainder;
+      return BigInt::divMod(leftOperand, rightOperand, solution, remainder) &&
+             remainder.isZero();
    }
 
-   traverseAndSimplifyHelper(root->left);
-   traverseAndSimplifyHelper(root->right);
-   // can only do something if two numbers and operand or else cant do anything
-   if (isOperator(root->token) || isPower(root->token))
+   const BigInt &base = leftOperand;
+   const BigInt &exponent = rightOperand;
+   if (base.bitLength() <= 1)
    {
-      if (root->left->token.type_ == number && root->right->token.type_ 
-      == number)
+      // 0, 1 and -1 stay small for any exponent
+      if (base.isZero() && exponent.isNegative())
       {
-         Token newToken = Token(number, calc(root->left->token.value_,
-         root->token.value_, root->right->token.value_));
-         delete root->right;
-         root->right = nullptr;
-         delete root->left;
-         root->left = nullptr;
-         root->token = newToken;
+         return false;
       }
+      solution = base.isZero() ? BigInt(exponent.isZero() ? 1 : 0)
+                               : (base.isNegative() && exponent.isOdd()
+                                      ? BigInt(-1)
+                                      : BigInt(1));
+      return true;
+   }
+   if (exponent.isNegative() || exponent.bitLength() > 32 ||
+       (base.bitLength() - 1) * uint64_t(exponent.toInt64()) > maxPowerBits)
+   {
+      return false;
    }
-   return;
+   solution = base.pow(exponent.toInt64());
+   return true;
 }
 
 /**
  * @brief calc
- * this function takes in two operands and an operator and performs
- * the correct calculation
+ * same as above on exact fractions, used when an operand or the result
+ * is not an integer
  *
  * @param leftOperand : operand that is left child
  * @param binop : operator
  * @param rightOperand : operand that is right child
- * @return string : string represenation of calculation
+ * @param solution : result of calculation
+ * @return true : if the result is exact
+ * @return false : if the calculation divides by zero, the power is not an
+ * integer or the power is too large to compute
  */
-string AST::calc(string leftOperand, string binop, string rightOperand) const
+bool AST::calc(const Rational &leftOperand, Opcode binop,
+               const Rational &rightOperand, Rational &solution)
 {
-   int right = stoi(leftOperand);
-   int left = stoi(rightOperand);
-   int solution;
-   if (binop == "+")
+   // largest power that is folded, in bits of the result
+   const size_t maxPowerBits = size_t(1) << 20;
+
+   if (binop == opAdd)
    {
-      solution = left + right;
+      solution = leftOperand + rightOperand;
+      return true;
    }
-   else if (binop == "-")
+   else if (binop == opSub)
    {
-      solution = left - right;
+      solution = leftOperand - rightOperand;
+      return true;
    }
-   else if (binop == "*")
+   else if (binop == opMul)
    {
-      solution = left * right;
+      solution = leftOperand * rightOperand;
+      return true;
    }
-   else if (binop == "/")
+   else if (binop == opDiv)
    {
-      solution = left / right;
+      return Rational::divide(leftOperand, rightOperand, solution);
    }
-   else
+   return Rational::pow(leftOperand, rightOperand, maxPowerBits, solution);
+}
+
+/**
+ * @brief integerValue
+ * PRE: the number is an integer
+ *
+ * @param node : number node
+ * @param scratch : holds the value if it fits in the token
+ * @return const BigInt& : value of the number
+ */
+const BigInt &AST::integerValue(const Node *node, BigInt &scratch)
+{
+   if (node->big != nullptr)
+   {
+      return node->big->numerator();
+   }
+   scratch = BigInt(node->token.number_);
+   return scratch;
+}
+
+/**
+ * @brief exactValue
+ *
+ * @param node : number node
+ * @param scratch : holds the value if it fits in the token
+ * @return const Rational& : value of the number
+ */
+const Rational &AST::exactValue(const Node *node, Rational &scratch)
+{
+   if (node->big != nullptr)
+   {
+      return *node->big;
+   }
+   scratch = Rational(node->token.number_);
+   return scratch;
+}
+
+/**
+ * @brief foldExact
+ * this function folds an operator whose operands are numbers that do not
+ * fit in an int64_t or are fractions. Integers are folded as BigInts and
+ * only a result that is a fraction is computed as a Rational. It is kept
+ * out of simplifyShared so the recursion does not carry the
+ * large values in every stack frame.
+ *
+ * @param root : operator node whose children are numbers
+ * @return true : if the node was replaced by its value
+ * @return false : if the calculation cannot be done exactly
+ */
+bool AST::foldExact(Node *root)
+{
+   Node *left = root->left;
+   Node *right = root->right;
+   if ((left->big == nullptr || left->big->isInteger()) &&
+       (right->big == nullptr || right->big->isInteger()))
+   {
+      BigInt solution;
+      BigInt leftScratch;
+      BigInt rightScratch;
+      if (calc(integerValue(left, leftScratch), root->token.op_,
+               integerValue(right, rightScratch), solution))
+      {
+         setNumber(root, Rational(solution));
+         return true;
+      }
+   }
+
+   Rational solution;
+   Rational leftScratch;
+   Rational rightScratch;
+   if (!calc(exactValue(left, leftScratch), root->token.op_,
+             exactValue(right, rightScratch), solution))
    {
-      solution = pow(left, right);
+      return false;
    }
+   setNumber(root, move(solution));
+   return true;
+}
 
-   return to_string(solution);
+/**
+ * @brief setNumber
+ * this function turns a node into a number node with the given value,
+ * keeping the value in the token if it fits and in the arena otherwise
+ *
+ * @param node : node to change
+ * @param value : value of the number
+ */
+void AST::setNumber(Node *node, Rational &&value)
+{
+   if (value.fitsInt64())
+   {
+      node->token = Token::fromNumber(value.toInt64());
+      node->big = nullptr;
+   }
+   else
+   {
+      node->token = Token(number);
+      node->big = arena_->create<Rational>(move(value));
+   }
 }
 
 /**
@@ -301,7 +1734,7 @@ string AST::calc(string leftOperand, string binop, string rightOperand) const
  * @return true : if the token is an operator
  * @return false : false if the token is not an operator
  */
-bool AST::isOperator(Token t) const
+bool AST::isOperator(const Token &t) const
 {
    if (t.type_ == binop)
    {
@@ -320,7 +1753,7 @@ bool AST::isOperator(Token t) const
  * @return true : if the token is a variable
  * @return false : false if the token is not a variable
  */
-bool AST::isVariable(Token t) const
+bool AST::isVariable(const Token &t) const
 {
    if (t.type_ == variable)
    {
@@ -339,7 +1772,7 @@ bool AST::isVariable(Token t) const
  * @return true : if the token is an operand
  * @return false : false if the token is not an operand
  */
-bool AST::isOperand(Token t) const
+bool AST::isOperand(const Token &t) const
 {
    if (t.type_ == number || t.type_ == variable)
    {
@@ -358,7 +1791,7 @@ bool AST::isOperand(Token t) const
  * @return true : if the token is a power operator
  * @return false : false if the token is not a power operator
  */
-bool AST::isPower(Token t) const
+bool AST::isPower(const Token &t) const
 {
    if (t.type_ == powop)
    {
@@ -379,49 +1812,167 @@ bool AST::isPower(Token t) const
  */
 string AST::toInfix(AST &newAST) const
 {
-   return toInfixHelper(newAST.root_);
+   string infix;
+   toInfixHelper(newAST.root_, infix, fullParentheses);
+   return infix;
 }
 
 /**
- * @brief toInfixHelper
- * this function takes in a node pointer and recursively converts the
- * AST into a string infix expression
+ * @brief toInfix
+ * this method appends the infix form of the tree to a string, so a caller
+ * can print many trees into one buffer
  *
- * @param node
- * @return string
+ * @param infix : string the expression is appended to
+ * @param print : how many parentheses are printed
  */
-string AST::toInfixHelper(Node *node) const
+void AST::toInfix(string &infix, PrintMode print) const
 {
-   string infix;
-   if (node == nullptr)
-      return infix;
+   toInfixHelper(root_, infix, print);
+}
 
-   if (isOperator(node->token))
+/**
+ * @brief parenthesized
+ * this function decides if an operand is printed in parentheses. With
+ * the fewest parentheses an operand is put in them when it binds more
+ * loosely than its operator, or as tightly on the side the operator does
+ * not group to, and a negative number when it could be read as a minus.
+ *
+ * @param print : how many parentheses are printed
+ * @param parent : operation the operand belongs to, opNone for the root
+ * @param operand : operation of the operand, opDiv for a fraction and
+ * opNone for any other number or a variable
+ * @param negative : true if the operand is a negative number
+ * @param right : true if it is the right operand
+ * @return true : if the operand is printed in parentheses
+ * @return false : if not
+ */
+bool AST::parenthesized(PrintMode print, Opcode parent, Opcode operand,
+                        bool negative, bool right)
+{
+   if (print == fullParentheses)
    {
-      string left = toInfixHelper(node->left);
-      string right = toInfixHelper(node->right);
-      infix += "(";
-      infix += left;
-      infix += node->token.value_;
-      infix += right;
-      infix += ")";
+      // -2^2 reads as -(2^2), so a negative base is put in them as well
+      return operand != opNone || (negative && parent == opPow && !right);
    }
-   else
+   if (parent == opNone)
+   {
+      return false;
+   }
+   // a-(-3) and (-3)^2 are not a minus sign away from a--3 and -3^2
+   if (negative && (right || parent == opPow))
+   {
+      return true;
+   }
+   if (operand == opNone)
+   {
+      return false;
+   }
+   int parentRank = opcodePrecedence(parent);
+   int operandRank = opcodePrecedence(operand);
+   if (operandRank != parentRank)
    {
-      return node->token.value_;
+      return operandRank < parentRank;
    }
+   // ^ groups to the right, the other operators to the left
+   return parent == opPow ? !right : right;
+}
 
-   return infix;
+/**
+ * @brief toInfixHelper
+ * this function appends the infix form of a subtree to a string, walking
+ * the tree with a stack of its own. Every character is written once at
+ * the end of the string.
+ *
+ * @param node : root of the subtree
+ * @param infix : string the expression is appended to
+ * @param print : how many parentheses are printed
+ */
+void AST::toInfixHelper(const Node *node, string &infix,
+                        PrintMode print) const
+{
+   if (node == nullptr)
+      return;
+
+   // decides if a node is printed in parentheses as an operand of parent
+   auto wrapped = [print](const Node *operand, Opcode parent, bool right) {
+      const Token &t = operand->token;
+      if (t.type_ == binop || t.type_ == powop)
+      {
+         return parenthesized(print, parent, t.op_, false, right);
+      }
+      if (t.type_ != number)
+      {
+         return parenthesized(print, parent, opNone, false, right);
+      }
+      if (operand->big == nullptr)
+      {
+         return parenthesized(print, parent, opNone, t.number_ < 0, right);
+      }
+      // a fraction is printed like a division
+      return parenthesized(print, parent,
+                           operand->big->isInteger() ? opNone : opDiv,
+                           operand->big->isNegative(), right);
+   };
+
+   // each entry is a node, how many of its operands were printed and if it
+   // is in parentheses, the stack is kept from one call to the next
+   static thread_local vector<Printing> walk;
+   walk.clear();
+   walk.push_back(Printing(node, 0, wrapped(node, opNone, false)));
+   while (!walk.empty())
+   {
+      Printing top = walk.back();
+      walk.pop_back();
+      const Node *current = top.node;
+      if (!isOperator(current->token) && !isPower(current->token))
+      {
+         if (top.wrapped)
+         {
+            infix += '(';
+         }
+         infix += current->big != nullptr ? current->big->toString()
+                                          : current->token.toString();
+         if (top.wrapped)
+         {
+            infix += ')';
+         }
+         continue;
+      }
+      Opcode op = current->token.op_;
+      if (top.printed == 0)
+      {
+         if (top.wrapped)
+         {
+            infix += '(';
+         }
+         walk.push_back(Printing(current, 1, top.wrapped));
+         walk.push_back(
+             Printing(current->left, 0, wrapped(current->left, op, false)));
+      }
+      else if (top.printed == 1)
+      {
+         infix += opcodeSymbol(op);
+         walk.push_back(Printing(current, 2, top.wrapped));
+         walk.push_back(
+             Printing(current->right, 0, wrapped(current->right, op, true)));
+      }
+      else if (top.wrapped)
+      {
+         infix += ')';
+      }
+   }
 }
 
-AST::Node::Node() : token(unknown, "unknown"), left(nullptr), right(nullptr){}
+AST::Node::Node() : token(unknown), left(nullptr), right(nullptr),
+big(nullptr) {}
 
 /**
  * @brief Construct a new Node object
  *
  * @param t : node is made up of a single token
  */
-AST::Node::Node(Token t) : token(t), left(nullptr), right(nullptr)
+AST::Node::Node(const Token &t) : token(t), left(nullptr), right(nullptr),
+big(nullptr)
 {
 }
 
@@ -432,5 +1983,6 @@ AST::Node::Node(Token t) : token(t), left(nullptr), right(nullptr)
  * @param leftptr : left node pointer
  * @param rightptr : right node pointer
  */
-AST::Node::Node(Token t, Node *leftptr, Node *rightptr) : token(t),
-left(leftptr), right(rightptr) {}
+AST::Node::Node(const Token &t, Node *leftptr, Node *rightptr) : token(t),
+left(leftptr), right(rightptr),
+big(nullptr) {}
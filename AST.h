@@ -13,12 +13,37 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include "Arena.h"
+#include "Rational.h"
 #include "Token.h"
 #include "TokenStream.h"
 #pragma once
 
+class Bytecode;
+class SymbolTable;
+
+/**
+ * @brief PrintMode
+ * Enum that selects how a tree is printed, either with every operator in
+ * parentheses or with only the parentheses the precedence of the operators
+ * needs
+ */
+enum PrintMode
+{
+  fullParentheses,
+  fewestParentheses
+};
+
 class AST
 {
+  // the flat storage reads the nodes when it flattens a tree
+  friend class FlatAST;
+  // the bytecode compiler reads the nodes when it compiles a tree
+  friend class Bytecode;
+  // the parser builds the nodes of a tree while it reads the tokens
+  friend class Parser;
 
 private:
   struct Node
@@ -30,7 +55,7 @@ private:
      *
      * @param t : node is made up of a single token
      */
-    Node(Token t);
+    Node(const Token &t);
 
     /**
      * @brief Construct a new Node object
@@ -39,7 +64,7 @@ private:
      * @param leftptr : left node pointer
      * @param rightptr : right node pointer
      */
-    Node(Token t, Node *leftptr, Node *rightptr);
+    Node(const Token &t, Node *leftptr, Node *rightptr);
 
     // token stores the type of token it is
     Token token;
@@ -47,28 +72,91 @@ private:
     Node *left;
     // pointer to right node
     Node *right;
+    // value of a number that does not fit in the token, it lives in an
+    // arena the tree keeps, nullptr otherwise
+    const Rational *big;
   };
 
   // root of the node (top)
   Node *root_;
 
+  // arena that every node of the tree is allocated from, it may be shared
+  // with other trees that are built for the same calculation
+  shared_ptr<Arena> arena_;
+
+  // arenas of other trees that unchanged subtrees of this tree are shared
+  // with, a simplified tree points into the trees it was simplified from
+  vector<shared_ptr<Arena> > borrowed_;
+
+  // values of stored trees that this tree points into. Each one keeps the
+  // arenas it points into itself, so a value is borrowed as a whole.
+  vector<shared_ptr<const AST> > borrowedValues_;
+
+  // for a stored tree, the tree with its variables substituted and
+  // simplified. It is made the first time the variable is used and kept
+  // until one of the variables it depends on is assigned.
+  shared_ptr<const AST> value_;
+
+  // sorted interned ids of the variables value_ was substituted with. A
+  // variable whose kept value was used is listed without what that value
+  // depends on, the symbol table follows dropped values from user to user.
+  vector<uint32_t> dependencies_;
+
+  // the tree compiled to bytecode, compiled the first time the tree is
+  // evaluated and dropped when the tree changes
+  mutable shared_ptr<const Bytecode> code_;
+
+  /**
+   * @brief makeNode
+   * this function creates a new node inside the arena of the tree, creating
+   * the arena first if the tree does not have one yet
+   *
+   * @param t : token of the node
+   * @param left : left node pointer
+   * @param right : right node pointer
+   * @return Node* : the new node
+   */
+  Node *makeNode(const Token &t, Node *left = nullptr, Node *right = nullptr);
+
+  /**
+   * @brief makeBigNumber
+   * this function creates a number node whose value does not fit in a token,
+   * the value is copied into the arena of the tree with the node
+   *
+   * @param value : value of the number
+   * @return Node* : the new node
+   */
+  Node *makeBigNumber(const Rational &value);
+
   /**
    * @brief copyTree
    * this function takes in the root of the tree to be copied and copies
-   * the tree. It then returns the new node of the copy.
+   * the tree without recursion. It then returns the new node of the copy.
    *
    * @param oldRoot : root of tree to be copied
    * @return Node* : new tree root
    */
-  Node *copyTree(const Node *oldRoot) const;
+  Node *copyTree(const Node *oldRoot);
 
   /**
-   * @brief clear
-   * this function takes in a root and clears the entire tree
+   * @brief copyTree
+   * same as above for a tree whose subtrees may be shared, each node is
+   * copied once and the copy is shared the same way
    *
-   * @param root
+   * @param oldRoot : root of tree to be copied
+   * @param copies : copy of each node that was copied already
+   * @return Node* : new tree root
    */
-  void clear(Node* &root);
+  Node *copyTree(const Node *oldRoot,
+                 unordered_map<const Node *, Node *> &copies);
+
+  /**
+   * @brief clear
+   * this function clears the entire tree at once by releasing the arena. If
+   * the arena is shared with other trees only this tree's reference is
+   * dropped, otherwise the arena is reset so its memory can be reused
+   */
+  void clear();
 
   /**
    * @brief constructTree
@@ -86,7 +174,7 @@ private:
    * @return true : if the token is an operator
    * @return false : false if the token is not an operator
    */
-  bool isOperator(Token t) const;
+  bool isOperator(const Token &t) const;
 
   /**
    * @brief isOperand
@@ -95,7 +183,7 @@ private:
    * @return true : if the token is an operand
    * @return false : false if the token is not an operand
    */
-  bool isOperand(Token t) const;
+  bool isOperand(const Token &t) const;
 
   /**
    * @brief isVariable
@@ -104,7 +192,7 @@ private:
    * @return true : if the token is a variable
    * @return false : false if the token is not a variable
    */
-  bool isVariable(Token t) const;
+  bool isVariable(const Token &t) const;
 
   /**
    * @brief isPower
@@ -113,90 +201,646 @@ private:
    * @return true : if the token is a power operator
    * @return false : false if the token is not a power operator
    */
-  bool isPower(Token t) const;
+  bool isPower(const Token &t) const;
+
 
   /**
-   * @brief calc
-   * this function takes in two operands and an operator and performs
-   * the correct calculation
+   * @brief integerValue
+   * PRE: the number is an integer
    *
-   * @param leftOperand : operand that is left child
-   * @param binop : operator
-   * @param rightOperand : operand that is right child
-   * @return string : string represenation of calculation
+   * @param node : number node
+   * @param scratch : holds the value if it fits in the token
+   * @return const BigInt& : value of the number
+   */
+  static const BigInt &integerValue(const Node *node, BigInt &scratch);
+
+  /**
+   * @brief exactValue
+   *
+   * @param node : number node
+   * @param scratch : holds the value if it fits in the token
+   * @return const Rational& : value of the number
+   */
+  static const Rational &exactValue(const Node *node, Rational &scratch);
+
+  /**
+   * @brief foldExact
+   * this function folds an operator whose operands are numbers that do not
+   * fit in an int64_t or are fractions
+   *
+   * @param root : operator node whose children are numbers
+   * @return true : if the node was replaced by its value
+   * @return false : if the calculation cannot be done exactly
+   */
+  bool foldExact(Node *root);
+
+  /**
+   * @brief setNumber
+   * this function turns a node into a number node with the given value,
+   * keeping the value in the token if it fits and in the arena otherwise
+   *
+   * @param node : node to change
+   * @param value : value of the number
+   */
+  void setNumber(Node *node, Rational &&value);
+
+  /**
+   * @brief NodeKey
+   * the parts of a node that make it unique, its token without the position
+   * of the text, the value of a big number and its children. Children are
+   * compared by address, which is enough because they were shared before
+   * their parent was made.
+   */
+  struct NodeKey
+  {
+    TokenType type;
+    Opcode op;
+    uint32_t id;
+    int64_t number;
+    const Rational *big;
+    const Node *left;
+    const Node *right;
+
+    bool operator==(const NodeKey &rhs) const;
+  };
+
+  /**
+   * @brief Expanding
+   * the variables whose definition is being substituted, in the order they
+   * were reached. The depth of each one is also kept by id, so finding a
+   * variable does not search the list and a long chain of definitions is
+   * substituted in linear time.
+   */
+  struct Expanding
+  {
+    // interned ids, the innermost definition last
+    vector<uint32_t> ids;
+
+    // one more than the index into ids of each variable, 0 for one that is
+    // not being substituted
+    vector<size_t> depthOf;
+
+    bool empty() const { return ids.empty(); }
+
+    size_t size() const { return ids.size(); }
+
+    void push(uint32_t id)
+    {
+      if (id >= depthOf.size())
+      {
+        depthOf.resize(id + 1, 0);
+      }
+      ids.push_back(id);
+      depthOf[id] = ids.size();
+    }
+
+    void pop()
+    {
+      depthOf[ids.back()] = 0;
+      ids.pop_back();
+    }
+
+    /**
+     * @brief depth
+     *
+     * @param id : interned id of a variable
+     * @return size_t : index into ids of the variable, SIZE_MAX if it is not
+     * being substituted
+     */
+    size_t depth(uint32_t id) const
+    {
+      return id < depthOf.size() && depthOf[id] != 0 ? depthOf[id] - 1
+                                                     : SIZE_MAX;
+    }
+  };
+
+  /**
+   * @brief Sharing
+   * the state of one simplification. Every node of the result is looked up
+   * in a table before it is made, so identical subtrees are one node and
+   * the result is a DAG. An operator is looked up by its operands, so one
+   * that was folded before is not folded again.
+   */
+  struct Sharing
+  {
+    struct Slot
+    {
+      NodeKey key;
+      Node *node;
+    };
+
+    // open addressing table of the shared nodes, allocated in the arena of
+    // the result so a reused arena does not allocate it again
+    Slot *slots;
+
+    // number of slots, a power of two
+    size_t capacity;
+
+    // number of slots in use
+    size_t used;
+
+    // arena of the result
+    Arena &arena;
+
+    // result of each variable whose value could not be cached, by
+    // interned id
+    unordered_map<uint32_t, Node *> definitions;
+
+    // variables whose definition is being substituted, one that refers to
+    // itself through these is left as a variable. Shared by the nested
+    // simplifications of the definitions.
+    Expanding &expanding;
+
+    // smallest index into expanding of a variable that was left as a
+    // variable because it was being substituted, SIZE_MAX if none was
+    size_t cycle;
+
+    // every variable the result names, by interned id, and every variable a
+    // definition it used without a kept value depends on. Only the value of
+    // a definition keeps them, so they are not recorded for the tree of a
+    // line.
+    vector<uint32_t> dependencies;
+
+    // true if dependencies are recorded, that is if the result is the
+    // value of a definition being substituted
+    bool tracking;
+
+    Sharing(Arena &resultArena, Expanding &expandingVariables)
+        : slots(nullptr), capacity(0), used(0), arena(resultArena),
+          expanding(expandingVariables), cycle(SIZE_MAX),
+          tracking(!expandingVariables.empty()) {}
+
+    /**
+     * @brief find
+     * this function finds the slot of a key. A new key gets a slot whose
+     * node is nullptr and the caller fills it in before the next find.
+     *
+     * @param key : key of a node
+     * @return Node*& : the node of the slot
+     */
+    Node *&find(const NodeKey &key);
+  };
+
+  /**
+   * @brief Expansion
+   * a definition being simplified into a tree of its own while the walk of
+   * the tree that uses it waits
+   */
+  struct Expansion
+  {
+    // interned id of the variable
+    uint32_t id;
+
+    // tree stored for the variable
+    AST *stored;
+
+    // number of variables that were being substituted before this one
+    size_t depth;
+
+    // the simplified definition
+    shared_ptr<AST> value;
+
+    // state of the simplification of the definition
+    Sharing sharing;
+
+    Expansion(uint32_t variable, AST &storedTree, size_t expandingDepth,
+              Expanding &expanding)
+        : id(variable), stored(&storedTree), depth(expandingDepth),
+          value(make_shared<AST>(make_shared<Arena>(4096))),
+          sharing(*value->arena_, expanding) {}
+  };
+
+  /**
+   * @brief StepKind
+   * what the walk of simplifyShared does with a node
+   */
+  enum StepKind : unsigned char
+  {
+    // simplify the node, pushing its operands first if it is an operator
+    visitStep,
+    // the operands of the operator are simplified, combine them
+    combineStep,
+    // the definition of the variable is simplified, use it
+    defineStep
+  };
+
+  /**
+   * @brief Step
+   * a node on the stack of the walk of simplifyShared
+   */
+  struct Step
+  {
+    Node *source;
+    StepKind kind;
+  };
+
+  /**
+   * @brief Printing
+   * a node on the stack of the walk of toInfixHelper
+   */
+  struct Printing
+  {
+    const Node *node;
+    // how many of the operands of the node were printed
+    int printed;
+    // true if the node is printed in parentheses
+    bool wrapped;
+
+    Printing(const Node *n, int count, bool parentheses)
+        : node(n), printed(count), wrapped(parentheses) {}
+  };
+
+  /**
+   * @brief keyOf
+   *
+   * @param t : token of the node
+   * @param big : value of a big number, nullptr otherwise
+   * @param left : shared left node
+   * @param right : shared right node
+   * @return NodeKey : key of the node
+   */
+  static NodeKey keyOf(const Token &t, const Rational *big, const Node *left,
+                       const Node *right);
+
+  /**
+   * @brief share
+   * this function looks a new node up in the table of shared nodes
+   * PRE: the children of the node are shared already
+   *
+   * @param sharing : state of the simplification
+   * @param node : node that was just made in the arena of the tree
+   * @return Node* : the node that was there first, or node if it is new
+   */
+  Node *share(Sharing &sharing, Node *node);
+
+  /**
+   * @brief simplifyShared
+   * this function substitutes the variables of a subtree and folds every
+   * operator whose operands are numbers. A variable is resolved through the
+   * table of variables when the walk reaches it, and its definition is
+   * simplified the same way. Only the nodes that change are made, a subtree
+   * that does not change is used as it is. The walk keeps its own stack,
+   * so neither a deep tree nor a long chain of definitions recurses.
+   *
+   * @param source : node of this tree or of a stored definition
+   * @param variables : table of the trees assigned to the variables
+   * @param sharing : state of the simplification
+   * @return Node* : the simplified subtree
+   */
+  Node *simplifyShared(Node *source, SymbolTable &variables,
+                       Sharing &sharing);
+
+  /**
+   * @brief combine
+   * this function makes the simplified operator of two simplified
+   * operands, folding it if both are numbers
+   *
+   * @param source : operator node of this tree or of a stored definition
+   * @param left : simplified left operand
+   * @param right : simplified right operand
+   * @param sharing : state of the simplification
+   * @return Node* : the simplified operator, source if nothing changed
+   */
+  Node *combine(Node *source, Node *left, Node *right, Sharing &sharing);
+
+  /**
+   * @brief Rewrite
+   * an operator that is being rewritten by the rules of the simplification.
+   * Its operands are simplified already. Once a rule turns it into a node
+   * of its own, such as an operand or a number, node holds that node.
+   */
+  struct Rewrite
+  {
+    Token token;
+    Node *left;
+    Node *right;
+    // the result when it is not an operator of left and right, nullptr
+    // while it is
+    Node *node;
+
+    Rewrite(const Token &t, Node *leftptr, Node *rightptr)
+        : token(t), left(leftptr), right(rightptr), node(nullptr) {}
+  };
+
+  /**
+   * @brief rewrite
+   * this function applies the rules of the simplification to an operator
+   * until none applies. The operands are simplified already, so only the
+   * operator that a rule made can match another rule, and it is rewritten
+   * again right away instead of walking the whole tree again.
+   *
+   * @param step : the operator, it receives the result
+   * @param sharing : state of the simplification
+   * @return true : if a rule changed the operator
+   * @return false : if no rule applies, nothing is made
    */
-  string calc(string leftOperand, string binop, string rightOperand) const;
+  bool rewrite(Rewrite &step, Sharing &sharing);
 
   /**
-   * @brief fillVariables
-   * this functions calls fillVariablesHelper, which is a recursive method
+   * @brief rule
+   * this function applies the first rule that matches an operator: folding
+   * numbers, removing an operand that is 0 or 1, collecting like terms
+   * such as 2*x+3*x and gathering the numbers of (x+2)+3 or 2*(3*x)
    *
-   * @param variables : map of variables with an associated AST
+   * @param step : the operator, it receives the result
+   * @param sharing : state of the simplification
+   * @return true : if a rule applied
+   * @return false : if none did
    */
-  void fillVariables(map<string, AST> &variables);
+  bool rule(Rewrite &step, Sharing &sharing);
 
   /**
-   * @brief fillVariablesHelper
-   * this functions takes in a map of variables and fills the variables that are
-   * in the current AST with the AST that is stored for that variable. The
-   * function takes in a root pointer and the map of variables
+   * @brief build
+   * this function makes the node of an operator that was rewritten, or
+   * finds the one that was made before
    *
-   * @param root : node pointer
-   * @param variables : map of variables
-   * @return Node* : node pointer
+   * @param step : the rewritten operator
+   * @param sharing : state of the simplification
+   * @return Node* : the node of the result
    */
-  Node *fillVariablesHelper(Node *&root, map<string, AST> &variables);
+  Node *build(const Rewrite &step, Sharing &sharing);
 
   /**
-   * @brief traverseAndSimplify
-   * this function calls the recursive travserse and simplify helper function
+   * @brief fold
+   * this function calculates an operator whose operands are numbers
    *
+   * @param op : the operation
+   * @param left : left number
+   * @param right : right number
+   * @param sharing : state of the simplification
+   * @return Node* : number node of the result, nullptr if the calculation
+   * cannot be done exactly
    */
-  void traverseAndSimplify();
+  Node *fold(Opcode op, Node *left, Node *right, Sharing &sharing);
 
   /**
-   * @brief traverseAndSimplifyHelper
-   * this function takes in a node pointer and traverses the tree calling calc()
-   * wherever an expression can be simplified
+   * @brief numberNode
    *
-   * @param root : node pointer
+   * @param value : value of the number
+   * @param sharing : state of the simplification
+   * @return Node* : shared number node of the value
    */
-  void traverseAndSimplifyHelper(Node *&root);
+  Node *numberNode(int64_t value, Sharing &sharing);
+
+  /**
+   * @brief sum
+   * this function sets an operator to base plus a number. A number that is
+   * 0 leaves the base and a negative number is subtracted instead.
+   *
+   * @param step : the operator, it receives the result
+   * @param base : the operand that is not a number
+   * @param offset : the number
+   * @param sharing : state of the simplification
+   */
+  void sum(Rewrite &step, Node *base, Node *offset, Sharing &sharing);
+
+  /**
+   * @brief offsetOf
+   * this function splits x+k, k+x and x-k into x and the number added to
+   * it
+   *
+   * @param node : a simplified node
+   * @param base : receives x
+   * @param sharing : state of the simplification
+   * @return Node* : the number added to x, negated for x-k, nullptr if the
+   * node is not a sum of a number
+   */
+  Node *offsetOf(Node *node, Node *&base, Sharing &sharing);
+
+  /**
+   * @brief coefficientOf
+   * this function splits k*x, x*k and 0-x into x and the number it is
+   * multiplied by
+   *
+   * @param node : a simplified node that is not a number
+   * @param base : receives x, the node itself if it is not such a product
+   * @param sharing : state of the simplification
+   * @return Node* : the number x is multiplied by, nullptr for 1
+   */
+  Node *coefficientOf(Node *node, Node *&base, Sharing &sharing);
+
+  /**
+   * @brief sameTree
+   * this function compares two subtrees node by node with a stack. Shared
+   * subtrees compare at once by address. A comparison that looks at more
+   * than a fixed number of nodes gives up, so the rules never make the
+   * simplification quadratic.
+   *
+   * @param a : first subtree
+   * @param b : second subtree
+   * @return true : if they are known to be the same expression
+   * @return false : if they differ or the comparison gave up
+   */
+  static bool sameTree(const Node *a, const Node *b);
+
+  /**
+   * @brief dividesByZero
+   * this function looks for a division by 0 that was left in a subtree
+   * because it cannot be done, such as 1/0 or 0^-1. The walk gives up
+   * after a fixed number of nodes and then answers true.
+   *
+   * @param node : a simplified subtree
+   * @return true : if the subtree may divide by 0
+   * @return false : if it does not
+   */
+  static bool dividesByZero(const Node *node);
+
+  /**
+   * @brief isValue
+   *
+   * @param node : a node
+   * @param value : a small integer
+   * @return true : if the node is a number with the value
+   * @return false : if not
+   */
+  static bool isValue(const Node *node, int64_t value);
+
+  /**
+   * @brief isNegative
+   *
+   * @param node : a node
+   * @return true : if the node is a number less than 0
+   * @return false : if not
+   */
+  static bool isNegative(const Node *node);
+
+  /**
+   * @brief define
+   * this function uses a definition that was just simplified for its
+   * variable. The value is kept for the stored tree unless it depends on
+   * where the variable was reached.
+   *
+   * @param expansion : the finished definition
+   * @param sharing : state of the simplification of this tree
+   * @param variables : table of the trees assigned to the variables
+   * @return Node* : value of the variable
+   */
+  Node *define(Expansion &expansion, Sharing &sharing,
+               SymbolTable &variables);
+
+  /**
+   * @brief borrow
+   * this function keeps the arena of another tree alive as long as this tree
+   * is, because nodes of this tree may point into it
+   *
+   * @param arena : arena of the other tree
+   */
+  void borrow(const shared_ptr<Arena> &arena);
+
+  /**
+   * @brief borrow
+   * same as above for the value of a stored tree, which keeps alive every
+   * arena it points into
+   *
+   * @param value : the value
+   */
+  void borrow(const shared_ptr<const AST> &value);
+
+  /**
+   * @brief runCode
+   * this function runs the compiled code of the tree, with each variable
+   * bound to the value of the AST stored for it
+   *
+   * @param code : code compiled from this tree
+   * @param variables : table of the trees assigned to the variables
+   * @param value : value of the expression
+   * @return true : if the tree evaluates to an int64_t
+   * @return false : if a variable has no value or a calculation cannot be
+   * done exactly on machine integers
+   */
+  bool runCode(const Bytecode &code, SymbolTable &variables,
+               int64_t &value) const;
+
+  /**
+   * @brief substitute
+   * this function finds the simplified value of a variable. A stored tree
+   * keeps its value, so it is only simplified again after one of the
+   * variables it depends on is assigned. A definition that has no value
+   * yet is left to the caller, which simplifies it and calls define().
+   *
+   * @param source : variable node
+   * @param variables : table of the trees assigned to the variables
+   * @param sharing : state of the simplification
+   * @return Node* : value of the variable, source if it has none, nullptr
+   * if its definition has to be simplified first
+   */
+  Node *substitute(Node *source, SymbolTable &variables,
+                   Sharing &sharing);
 
   /**
    * @brief toInfixHelper
-   * this function takes in a node pointer and recursively converts the
-   * AST into a string infix expression
+   * this function appends the infix form of a subtree to a string, walking
+   * the tree with a stack of its own. Every character is written once at
+   * the end of the string.
    *
-   * @param node
-   * @return string
+   * @param node : root of the subtree
+   * @param infix : string the expression is appended to
+   * @param print : how many parentheses are printed
    */
-  string toInfixHelper(Node *node) const;
+  void toInfixHelper(const Node *node, string &infix, PrintMode print) const;
 
 public:
+  /**
+   * @brief calc
+   * this function takes in two operands and an operator and performs
+   * the correct calculation on machine integers
+   *
+   * @param leftOperand : operand that is left child
+   * @param binop : operator
+   * @param rightOperand : operand that is right child
+   * @param solution : result of calculation
+   * @return true : if the result is an exact integer
+   * @return false : if the calculation overflows, divides by zero or the
+   * result is a fraction
+   */
+  static bool calc(int64_t leftOperand, Opcode binop, int64_t rightOperand,
+                   int64_t &solution);
+
+  /**
+   * @brief calc
+   * same as above on arbitrary precision integers, used when an operand or
+   * the result does not fit in an int64_t
+   *
+   * @param leftOperand : operand that is left child
+   * @param binop : operator
+   * @param rightOperand : operand that is right child
+   * @param solution : result of calculation
+   * @return true : if the result is an exact integer
+   * @return false : if the calculation divides by zero, the result is a
+   * fraction or the power is too large to compute
+   */
+  static bool calc(const BigInt &leftOperand, Opcode binop,
+                   const BigInt &rightOperand, BigInt &solution);
+
+  /**
+   * @brief calc
+   * same as above on exact fractions, used when an operand or the result
+   * is not an integer
+   *
+   * @param leftOperand : operand that is left child
+   * @param binop : operator
+   * @param rightOperand : operand that is right child
+   * @param solution : result of calculation
+   * @return true : if the result is exact
+   * @return false : if the calculation divides by zero, the power is not an
+   * integer or the power is too large to compute
+   */
+  static bool calc(const Rational &leftOperand, Opcode binop,
+                   const Rational &rightOperand, Rational &solution);
+
   /**
    * @brief Construct a new AST object
    * default constructor
    */
   AST() : root_(nullptr) {}
 
+  /**
+   * @brief Construct a new AST object
+   * an empty tree whose nodes will be allocated from the given arena
+   *
+   * @param arena : arena to allocate the nodes from
+   */
+  explicit AST(shared_ptr<Arena> arena) : root_(nullptr), arena_(move(arena)) {}
+
   /**
    * @brief Construct a new AST object
    * constructs an AST via only a single token, this is used to initialize the
    * map of variables
    * @param t
    */
-  AST(Token t);
+  explicit AST(const Token &t);
+
+  /**
+   * @brief Construct a new AST object
+   * same as above but allocates the node from the given arena
+   *
+   * @param t : token of the only node
+   * @param arena : arena to allocate the node from
+   */
+  AST(const Token &t, shared_ptr<Arena> arena);
 
   /**
    * @brief Construct a new AST object
    * this functions takes in a vector of tokens in post fix
    * and creates a binary tree from the nodes up
+   * PRE: every number fits in its token, the value of a bigger one is kept
+   * by the TokenStream that read it and copied in by the Parser
    *
    * @param postfixExpr
    */
   AST(vector<Token> &postfix);
 
+  /**
+   * @brief Construct a new AST object
+   * same as above but allocates the nodes from an arena that can be shared
+   * with other trees, so trees built for one calculation are released
+   * together
+   *
+   * @param postfix : vector of tokens in postfix form
+   * @param arena : arena to allocate the nodes from
+   */
+  AST(vector<Token> &postfix, shared_ptr<Arena> arena);
+
   /**
    * @brief Construct a new AST object
    * copy constructor that calls copyTree()
@@ -205,6 +849,15 @@ public:
    */
   AST(const AST &ast);
 
+  /**
+   * @brief Construct a new AST object
+   * copies the tree of ast into the given arena
+   *
+   * @param ast : AST to copy
+   * @param arena : arena to allocate the copied nodes from
+   */
+  AST(const AST &ast, shared_ptr<Arena> arena);
+
   /**
    * @brief operator=
    * this is an assignment operator that assigns the ast passed in
@@ -214,6 +867,33 @@ public:
    */
   AST &operator=(const AST &ast);
 
+  /**
+   * @brief Construct a new AST object
+   * move constructor, the nodes and the arena are taken from ast and ast is
+   * left empty
+   *
+   * @param ast : AST to move from
+   */
+  AST(AST &&ast) noexcept;
+
+  /**
+   * @brief operator=
+   * move assignment, the nodes and the arena are taken from ast and ast is
+   * left empty
+   *
+   * @param ast : AST to move from
+   * @return AST& : this AST
+   */
+  AST &operator=(AST &&ast) noexcept;
+
+  /**
+   * @brief empty
+   *
+   * @return true : if the tree has no nodes
+   * @return false : if it has
+   */
+  bool empty() const { return root_ == nullptr; }
+
   /**
    * @brief Destroy the AST object
    *
@@ -222,13 +902,88 @@ public:
 
   /**
    * @brief simplify
-   * this method takes in the map of variables and creates a copy of the
-   * current AST. It then calles fillVariables and traverseAndSimplify on
-   * the copy and returns the simplifed copy
+   * this method takes in the table of variables and builds the simplified
+   * tree, with every variable replaced by its stored AST and every
+   * calculation done that can be done exactly. A tree that evaluates to a
+   * number is run on its bytecode instead and no tree is built.
    * @param variables: an array that holds the variables that can be stored
+   * @param arena : arena for the copy, a new one is created if it is null
+   * @return AST : returned simplified AST
+   */
+  AST simplify(SymbolTable &variables,
+               shared_ptr<Arena> arena = shared_ptr<Arena>());
+
+  /**
+   * @brief simplify
+   * same as above for a tree that is simplified once, the tree is compiled
+   * into the given bytecode instead of code of its own
+   *
+   * @param variables : table of the trees assigned to the variables
+   * @param scratch : bytecode the tree is compiled into
+   * @param arena : arena for the copy, a new one is created if it is null
    * @return AST : returned simplified AST
    */
-  AST simplify(map<string, AST> &variables);
+  AST simplify(SymbolTable &variables, Bytecode &scratch,
+               shared_ptr<Arena> arena = shared_ptr<Arena>());
+
+  /**
+   * @brief simplifyTree
+   * same as simplify but always walks the tree, this is what simplify falls
+   * back to when the bytecode cannot evaluate the tree. Identical subtrees
+   * of the result are one shared node, so a chain of definitions that each
+   * use the one before twice is built in linear time and memory. Subtrees of
+   * this tree and of the stored definitions that do not change are pointed
+   * at instead of copied.
+   *
+   * @param variables : table of the trees assigned to the variables
+   * @param arena : arena for the nodes that change, a new one is created if
+   * it is null
+   * @return AST : returned simplified AST
+   */
+  AST simplifyTree(SymbolTable &variables,
+                   shared_ptr<Arena> arena = shared_ptr<Arena>());
+
+  /**
+   * @brief invalidate
+   * this method drops the value kept for a stored tree if it depends on the
+   * given variable, it is called when the variable is assigned or its own
+   * value is dropped
+   *
+   * @param id : interned id of the variable that changed
+   * @return true : if the value was dropped
+   * @return false : if there was no value or it does not depend on id
+   */
+  bool invalidate(uint32_t id);
+
+  /**
+   * @brief evaluate
+   * this method evaluates the tree with its bytecode. The bytecode is
+   * compiled the first time and reused after that. Each variable is bound to
+   * the value of the AST stored for it, which must not have variables itself
+   * unless the value kept for it is a number.
+   *
+   * @param variables : table of the trees assigned to the variables
+   * @param value : value of the expression
+   * @return true : if the tree evaluates to an int64_t
+   * @return false : if a variable has no value or a calculation cannot be
+   * done exactly on machine integers
+   */
+  bool evaluate(SymbolTable &variables, int64_t &value) const;
+
+  /**
+   * @brief evaluate
+   * same as above but compiles the tree into the given bytecode instead of
+   * keeping code of its own, for a tree that is evaluated once
+   *
+   * @param variables : table of the trees assigned to the variables
+   * @param value : value of the expression
+   * @param scratch : bytecode the tree is compiled into
+   * @return true : if the tree evaluates to an int64_t
+   * @return false : if a variable has no value or a calculation cannot be
+   * done exactly on machine integers
+   */
+  bool evaluate(SymbolTable &variables, int64_t &value,
+                Bytecode &scratch) const;
 
   /**
    * @brief
@@ -238,4 +993,35 @@ public:
    * @return string : infix form of expression
    */
   string toInfix(AST &newAST) const;
+
+  /**
+   * @brief toInfix
+   * this method appends the infix form of the tree to a string, so a caller
+   * can print many trees into one buffer
+   *
+   * @param infix : string the expression is appended to
+   * @param print : how many parentheses are printed
+   */
+  void toInfix(string &infix, PrintMode print = fullParentheses) const;
+
+  /**
+   * @brief parenthesized
+   * this function decides if an operand is printed in parentheses. With
+   * every parenthesis an operator is put in them, and so is a negative
+   * number that is the base of a power. With the fewest parentheses an
+   * operand is put in them when it binds more loosely than its operator, or
+   * as tightly on the side the operator does not group to, and a negative
+   * number when it could be read as a minus.
+   *
+   * @param print : how many parentheses are printed
+   * @param parent : operation the operand belongs to, opNone for the root
+   * @param operand : operation of the operand, opDiv for a fraction and
+   * opNone for any other number or a variable
+   * @param negative : true if the operand is a negative number
+   * @param right : true if it is the right operand
+   * @return true : if the operand is printed in parentheses
+   * @return false : if not
+   */
+  static bool parenthesized(PrintMode print, Opcode parent, Opcode operand,
+                            bool negative, bool right);
 };
@@ -0,0 +1,108 @@
+/**
+ * @file Arena.cpp
+ * @author Katarina McGaughy
+ * @brief The Arena class is a bump allocator that hands out memory from large
+ * blocks. Objects created in the arena are never deleted one at a time, the
+ * whole arena is released at once when it is reset or destroyed.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Arena.h"
+using namespace std;
+
+/**
+ * @brief Construct a new Arena object
+ * no memory is allocated until the first object is created
+ *
+ * @param blockSize : size in bytes of each block
+ */
+Arena::Arena(size_t blockSize) : current_(0), cursor_(nullptr),
+                                 limit_(nullptr), blockSize_(blockSize)
+{
+}
+
+/**
+ * @brief Destroy the Arena object
+ * runs any finalizers and frees every block
+ */
+Arena::~Arena()
+{
+   runFinalizers();
+   for (size_t i = 0; i < blocks_.size(); i++)
+   {
+      ::operator delete(blocks_[i].data);
+   }
+}
+
+/**
+ * @brief grow
+ * this function moves the arena onto a block that has room for at least
+ * size bytes, reusing a block from before the last reset() if one is large
+ * enough and allocating a new one otherwise
+ *
+ * @param size : number of bytes needed
+ */
+void Arena::grow(size_t size)
+{
+   // blocks after current_ are left over from before a reset()
+   size_t next = cursor_ == nullptr ? current_ : current_ + 1;
+   while (next < blocks_.size() && blocks_[next].size < size)
+   {
+      next++;
+   }
+   if (next == blocks_.size())
+   {
+      size_t blockSize = size > blockSize_ ? size : blockSize_;
+      Block block = {static_cast<char *>(::operator new(blockSize)),
+                     blockSize};
+      blocks_.push_back(block);
+   }
+   current_ = next;
+   cursor_ = blocks_[current_].data;
+   limit_ = cursor_ + blocks_[current_].size;
+}
+
+/**
+ * @brief runFinalizers
+ * this function destroys every object that was registered with a finalizer
+ * in the reverse order of creation
+ */
+void Arena::runFinalizers()
+{
+   for (size_t i = finalizers_.size(); i > 0; i--)
+   {
+      finalizers_[i - 1].destroy(finalizers_[i - 1].object);
+   }
+   finalizers_.clear();
+}
+
+/**
+ * @brief reset
+ * this function releases every object in the arena at once. The blocks
+ * are kept so the next objects created reuse the same memory.
+ */
+void Arena::reset()
+{
+   runFinalizers();
+   current_ = 0;
+   cursor_ = nullptr;
+   limit_ = nullptr;
+}
+
+/**
+ * @brief bytesReserved
+ *
+ * @return size_t : total size of all blocks owned by the arena
+ */
+size_t Arena::bytesReserved() const
+{
+   size_t total = 0;
+   for (size_t i = 0; i < blocks_.size(); i++)
+   {
+      total += blocks_[i].size;
+   }
+   return total;
+}
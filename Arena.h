@@ -0,0 +1,161 @@
+/**
+ * @file Arena.h
+ * @author Katarina McGaughy
+ * @brief The Arena class is a bump allocator that hands out memory from large
+ * blocks. Objects created in the arena are never deleted one at a time, the
+ * whole arena is released at once when it is reset or destroyed. Objects that
+ * need their destructor run are remembered in a finalizer list, objects that
+ * are trivially destructible cost nothing to release.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#pragma once
+using namespace std;
+
+class Arena
+{
+
+private:
+   /**
+    * @brief Block
+    * a contiguous chunk of memory that the arena bumps through
+    */
+   struct Block
+   {
+      char *data;
+      size_t size;
+   };
+
+   /**
+    * @brief Finalizer
+    * an object living in the arena along with the function that destroys it
+    */
+   struct Finalizer
+   {
+      void *object;
+      void (*destroy)(void *);
+   };
+
+   // every block the arena has allocated, blocks are reused after reset()
+   vector<Block> blocks_;
+
+   // index of the block currently being bumped through
+   size_t current_;
+
+   // next free byte in the current block
+   char *cursor_;
+
+   // one past the last byte of the current block
+   char *limit_;
+
+   // default size of a new block
+   size_t blockSize_;
+
+   // objects whose destructor has to run when the arena is released
+   vector<Finalizer> finalizers_;
+
+   /**
+    * @brief grow
+    * this function moves the arena onto a block that has room for at least
+    * size bytes, reusing a block from before the last reset() if one is large
+    * enough and allocating a new one otherwise
+    *
+    * @param size : number of bytes needed
+    */
+   void grow(size_t size);
+
+   /**
+    * @brief runFinalizers
+    * this function destroys every object that was registered with a finalizer
+    * in the reverse order of creation
+    */
+   void runFinalizers();
+
+   template <typename T>
+   static void destroyObject(void *object)
+   {
+      static_cast<T *>(object)->~T();
+   }
+
+public:
+   /**
+    * @brief Construct a new Arena object
+    * no memory is allocated until the first object is created
+    *
+    * @param blockSize : size in bytes of each block
+    */
+   explicit Arena(size_t blockSize = 64 * 1024);
+
+   /**
+    * @brief Destroy the Arena object
+    * runs any finalizers and frees every block
+    */
+   ~Arena();
+
+   Arena(const Arena &) = delete;
+   Arena &operator=(const Arena &) = delete;
+
+   /**
+    * @brief allocate
+    * this function returns size bytes of memory aligned to align
+    *
+    * @param size : number of bytes
+    * @param align : required alignment, must be a power of two
+    * @return void* : pointer to uninitialized memory
+    */
+   void *allocate(size_t size, size_t align)
+   {
+      char *p = reinterpret_cast<char *>(
+          (reinterpret_cast<size_t>(cursor_) + align - 1) & ~(align - 1));
+      if (cursor_ == nullptr || p + size > limit_)
+      {
+         grow(size + align);
+         p = reinterpret_cast<char *>(
+             (reinterpret_cast<size_t>(cursor_) + align - 1) & ~(align - 1));
+      }
+      cursor_ = p + size;
+      return p;
+   }
+
+   /**
+    * @brief create
+    * this function constructs a T inside the arena. If T is not trivially
+    * destructible its destructor is recorded so reset() can run it.
+    *
+    * @param args : constructor arguments
+    * @return T* : the new object
+    */
+   template <typename T, typename... Args>
+   T *create(Args &&...args)
+   {
+      T *object = new (allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+      if (!is_trivially_destructible<T>::value)
+      {
+         finalizers_.push_back(Finalizer{object, &destroyObject<T>});
+      }
+      return object;
+   }
+
+   /**
+    * @brief reset
+    * this function releases every object in the arena at once. The blocks
+    * are kept so the next objects created reuse the same memory.
+    */
+   void reset();
+
+   /**
+    * @brief bytesReserved
+    *
+    * @return size_t : total size of all blocks owned by the arena
+    */
+   size_t bytesReserved() const;
+};
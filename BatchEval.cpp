@@ -0,0 +1,337 @@
+/**
+ * @file BatchEval.cpp
+ * @author Katarina McGaughy
+ * @brief The BatchEval class evaluates one expression over many bindings of
+ * its variables. Every instruction of the compiled expression is run on a
+ * block of rows at a time with SIMD instructions. AVX is used when the
+ * compiler targets it, SSE2 otherwise and a plain loop on other machines.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "BatchEval.h"
+#include "Symbols.h"
+#include <cmath>
+#include <cstring>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+/**
+ * @brief AddOp, SubOp, MulOp, DivOp
+ * the operation of an instruction on one value and on a SIMD register
+ */
+struct AddOp
+{
+   static double apply(double a, double b) { return a + b; }
+#if defined(__AVX__)
+   static __m256d apply(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#elif defined(__SSE2__)
+   static __m128d apply(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+#endif
+};
+
+struct SubOp
+{
+   static double apply(double a, double b) { return a - b; }
+#if defined(__AVX__)
+   static __m256d apply(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+#elif defined(__SSE2__)
+   static __m128d apply(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+#endif
+};
+
+struct MulOp
+{
+   static double apply(double a, double b) { return a * b; }
+#if defined(__AVX__)
+   static __m256d apply(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+#elif defined(__SSE2__)
+   static __m128d apply(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+#endif
+};
+
+struct DivOp
+{
+   static double apply(double a, double b) { return a / b; }
+#if defined(__AVX__)
+   static __m256d apply(__m256d a, __m256d b) { return _mm256_div_pd(a, b); }
+#elif defined(__SSE2__)
+   static __m128d apply(__m128d a, __m128d b) { return _mm_div_pd(a, b); }
+#endif
+};
+
+/**
+ * @brief applyBlock
+ * this function applies an operation to n pairs of values, a SIMD register
+ * at a time and one value at a time for the rows that are left over. out
+ * may be the same block as a or b.
+ *
+ * @param a : left operands
+ * @param b : right operands
+ * @param out : results
+ * @param n : number of values
+ */
+template <typename Op>
+static void applyBlock(const double *a, const double *b, double *out,
+                       size_t n)
+{
+   size_t i = 0;
+#if defined(__AVX__)
+   for (; i + 4 <= n; i += 4)
+   {
+      _mm256_storeu_pd(out + i, Op::apply(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+   }
+#elif defined(__SSE2__)
+   for (; i + 2 <= n; i += 2)
+   {
+      _mm_storeu_pd(out + i, Op::apply(_mm_loadu_pd(a + i),
+                                       _mm_loadu_pd(b + i)));
+   }
+#endif
+   for (; i < n; i++)
+   {
+      out[i] = Op::apply(a[i], b[i]);
+   }
+}
+
+/**
+ * @brief Construct a new BatchEval object
+ * this constructor compiles the expression of an AST and marks the powers
+ * whose exponent is a constant integer, those are computed by squaring
+ * whole blocks instead of calling pow() on every row
+ *
+ * @param ast : expression to evaluate
+ */
+BatchEval::BatchEval(const AST &ast) : code_(ast)
+{
+   constantPower_.resize(code_.code_.size(), false);
+   for (int i = 1; i < code_.code_.size(); i++)
+   {
+      constantPower_[i] = code_.code_[i].op == bcPow &&
+                          code_.code_[i - 1].op == bcPushConst;
+   }
+}
+
+/**
+ * @brief variables
+ *
+ * @return vector<string> : names of the variables of the expression, the
+ * columns are passed in this order
+ */
+vector<string> BatchEval::variables() const
+{
+   vector<string> names;
+   for (int i = 0; i < code_.variables_.size(); i++)
+   {
+      names.push_back(Symbols::name(code_.variables_[i]));
+   }
+   return names;
+}
+
+/**
+ * @brief evaluate
+ * this function evaluates rows [begin, end) of the columns. It only reads
+ * the compiled expression, so several threads can evaluate different rows
+ * at the same time.
+ * PRE: valid() and every column has at least end rows
+ *
+ * @param columns : column of each variable, in the order of variables()
+ * @param begin : first row
+ * @param end : one past the last row
+ * @param result : column of results, row i is written to result[i]
+ */
+void BatchEval::evaluate(const double *const *columns, size_t begin,
+                         size_t end, double *result) const
+{
+   // one block per entry of the operand stack, then one block per constant
+   // that is filled once and read by every block of rows
+   size_t height = code_.stack_.size();
+   vector<double> scratch((height + code_.constants_.size()) * blockRows);
+   for (int c = 0; c < code_.constants_.size(); c++)
+   {
+      double *block = scratch.data() + (height + c) * blockRows;
+      for (int i = 0; i < blockRows; i++)
+      {
+         block[i] = double(code_.constants_[c]);
+      }
+   }
+
+   for (size_t row = begin; row < end; row += blockRows)
+   {
+      size_t rows = end - row < blockRows ? end - row : blockRows;
+      evaluateBlock(columns, row, rows, scratch.data(), result + row);
+   }
+}
+
+/**
+ * @brief evaluate
+ * same as above on the workers of a thread pool. The rows are cut into
+ * chunks that the workers balance between them, and every worker writes
+ * its rows straight into result.
+ * PRE: valid() and every column has at least end rows
+ *
+ * @param columns : column of each variable, in the order of variables()
+ * @param begin : first row
+ * @param end : one past the last row
+ * @param result : column of results, row i is written to result[i]
+ * @param pool : threads to evaluate on
+ */
+void BatchEval::evaluate(const double *const *columns, size_t begin,
+                         size_t end, double *result, ThreadPool &pool) const
+{
+   pool.parallelFor(begin, end, chunkRows,
+                    [this, columns, result](size_t first, size_t last) {
+                       evaluate(columns, first, last, result);
+                    });
+}
+
+/**
+ * @brief evaluateBlock
+ * this function runs the code on rows [begin, begin + rows). The operand
+ * stack holds pointers to blocks, so loading a variable or a constant does
+ * not copy anything and only operators write to the scratch blocks.
+ *
+ * @param columns : column of each slot
+ * @param begin : first row
+ * @param rows : number of rows, at most blockRows
+ * @param scratch : maxHeight blocks of blockRows values
+ * @param result : receives the value of each row
+ */
+void BatchEval::evaluateBlock(const double *const *columns, size_t begin,
+                              size_t rows, double *scratch,
+                              double *result) const
+{
+   size_t height = code_.stack_.size();
+   const double *fewOperands[32];
+   vector<const double *> manyOperands;
+   const double **operand = fewOperands;
+   if (height > 32)
+   {
+      manyOperands.resize(height);
+      operand = manyOperands.data();
+   }
+
+   // index of the next free entry of the stack
+   size_t top = 0;
+   for (int i = 0; i < code_.code_.size(); i++)
+   {
+      const Bytecode::Instruction &ip = code_.code_[i];
+      if (ip.op == bcPushConst)
+      {
+         operand[top++] = scratch + (height + ip.arg) * blockRows;
+         continue;
+      }
+      if (ip.op == bcLoadVar)
+      {
+         operand[top++] = columns[ip.arg] + begin;
+         continue;
+      }
+
+      top--;
+      const double *a = operand[top - 1];
+      const double *b = operand[top];
+      double *out = scratch + (top - 1) * blockRows;
+      switch (ip.op)
+      {
+      case bcAdd:
+         applyBlock<AddOp>(a, b, out, rows);
+         break;
+      case bcSub:
+         applyBlock<SubOp>(a, b, out, rows);
+         break;
+      case bcMul:
+         applyBlock<MulOp>(a, b, out, rows);
+         break;
+      case bcDiv:
+         applyBlock<DivOp>(a, b, out, rows);
+         break;
+      default:
+         if (constantPower_[i])
+         {
+            // the block of the exponent is free, it holds the squares
+            int64_t exponent = code_.constants_[code_.code_[i - 1].arg];
+            uint64_t power = exponent < 0 ? -uint64_t(exponent) : exponent;
+            double *square = scratch + top * blockRows;
+            memcpy(square, a, rows * sizeof(double));
+            for (int r = 0; r < rows; r++)
+            {
+               out[r] = 1.0;
+            }
+            while (power > 0)
+            {
+               if (power & 1)
+               {
+                  applyBlock<MulOp>(out, square, out, rows);
+               }
+               power >>= 1;
+               if (power > 0)
+               {
+                  applyBlock<MulOp>(square, square, square, rows);
+               }
+            }
+            if (exponent < 0)
+            {
+               for (int r = 0; r < rows; r++)
+               {
+                  out[r] = 1.0 / out[r];
+               }
+            }
+         }
+         else
+         {
+            for (int r = 0; r < rows; r++)
+            {
+               out[r] = pow(a[r], b[r]);
+            }
+         }
+         break;
+      }
+      operand[top - 1] = out;
+   }
+   memcpy(result, operand[0], rows * sizeof(double));
+}
+
+/**
+ * @brief evaluate
+ * this function evaluates every row of the columns
+ *
+ * @param columns : map of variable names to their column
+ * @param result : column of results
+ * @return true : if every variable has a column and all columns have the
+ * same number of rows
+ * @return false : if not, result is not changed
+ */
+bool BatchEval::evaluate(const map<string, vector<double> > &columns,
+                         vector<double> &result) const
+{
+   if (!valid())
+   {
+      return false;
+   }
+   vector<string> names = variables();
+   vector<const double *> slots;
+   size_t rows = 0;
+   for (int i = 0; i < names.size(); i++)
+   {
+      map<string, vector<double> >::const_iterator it = columns.find(names[i]);
+      if (it == columns.end() || (i > 0 && it->second.size() != rows))
+      {
+         return false;
+      }
+      rows = it->second.size();
+      slots.push_back(it->second.data());
+   }
+   if (names.empty())
+   {
+      // an expression without variables has one row
+      rows = 1;
+   }
+   result.resize(rows);
+   evaluate(slots.data(), 0, rows, result.data());
+   return true;
+}
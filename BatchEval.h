@@ -0,0 +1,128 @@
+/**
+ * @file BatchEval.h
+ * @author Katarina McGaughy
+ * @brief The BatchEval class evaluates one expression over many bindings of
+ * its variables. The values of each variable are given as a column and the
+ * result is a column with one value per row. The expression is compiled to
+ * bytecode once and every instruction is run on a block of rows at a time
+ * with SIMD instructions, so the cost of decoding an instruction is shared
+ * by the whole block.
+ * Values are doubles, so division and large powers are rounded the way
+ * floating point rounds them. Exact results come from AST::simplify.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "Bytecode.h"
+#include "ThreadPool.h"
+#pragma once
+using namespace std;
+
+class BatchEval
+{
+
+private:
+   // number of rows every instruction is run on at a time, small enough that
+   // the blocks of the operand stack stay in the L1 cache
+   static const size_t blockRows = 256;
+
+   // number of rows in a chunk handed to a worker of a thread pool
+   static const size_t chunkRows = 64 * blockRows;
+
+   // the compiled expression
+   Bytecode code_;
+
+   // true if the exponent of each bcPow is a constant integer, indexed by
+   // the position of the instruction
+   vector<bool> constantPower_;
+
+   /**
+    * @brief evaluateBlock
+    * this function runs the code on rows [begin, begin + rows)
+    *
+    * @param columns : column of each slot
+    * @param begin : first row
+    * @param rows : number of rows, at most blockRows
+    * @param scratch : maxHeight blocks of blockRows values
+    * @param result : receives the value of each row
+    */
+   void evaluateBlock(const double *const *columns, size_t begin, size_t rows,
+                      double *scratch, double *result) const;
+
+public:
+   /**
+    * @brief Construct a new BatchEval object
+    * this constructor compiles the expression of an AST
+    *
+    * @param ast : expression to evaluate
+    */
+   explicit BatchEval(const AST &ast);
+
+   /**
+    * @brief valid
+    *
+    * @return true : if the expression can be evaluated
+    * @return false : if the tree was empty or held a value that does not fit
+    * in an int64_t
+    */
+   bool valid() const { return code_.valid(); }
+
+   /**
+    * @brief variables
+    *
+    * @return vector<string> : names of the variables of the expression, the
+    * columns are passed in this order
+    */
+   vector<string> variables() const;
+
+   /**
+    * @brief evaluate
+    * this function evaluates rows [begin, end) of the columns. It only reads
+    * the compiled expression, so several threads can evaluate different rows
+    * at the same time.
+    * PRE: valid() and every column has at least end rows
+    *
+    * @param columns : column of each variable, in the order of variables()
+    * @param begin : first row
+    * @param end : one past the last row
+    * @param result : column of results, row i is written to result[i]
+    */
+   void evaluate(const double *const *columns, size_t begin, size_t end,
+                 double *result) const;
+
+   /**
+    * @brief evaluate
+    * same as above on the workers of a thread pool. The rows are cut into
+    * chunks that the workers balance between them, and every worker writes
+    * its rows straight into result.
+    * PRE: valid() and every column has at least end rows
+    *
+    * @param columns : column of each variable, in the order of variables()
+    * @param begin : first row
+    * @param end : one past the last row
+    * @param result : column of results, row i is written to result[i]
+    * @param pool : threads to evaluate on
+    */
+   void evaluate(const double *const *columns, size_t begin, size_t end,
+                 double *result, ThreadPool &pool) const;
+
+   /**
+    * @brief evaluate
+    * this function evaluates every row of the columns
+    *
+    * @param columns : map of variable names to their column
+    * @param result : column of results
+    * @return true : if every variable has a column and all columns have the
+    * same number of rows
+    * @return false : if not, result is not changed
+    */
+   bool evaluate(const map<string, vector<double> > &columns,
+                 vector<double> &result) const;
+};
@@ -0,0 +1,868 @@
+/**
+ * @file BigInt.cpp
+ * @author Katarina McGaughy
+ * @brief The BigInt class is an arbitrary precision integer. The magnitude is
+ * stored in 32 bit limbs with the least significant limb first. Large
+ * products use Karatsuba multiplication and powers use exponentiation by
+ * squaring, so folding large powers and products stays exact.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "BigInt.h"
+#include <algorithm>
+using namespace std;
+
+/**
+ * @brief Construct a new BigInt object
+ *
+ * @param value : value of the integer
+ */
+BigInt::BigInt(int64_t value) : negative_(value < 0)
+{
+   // negate as unsigned so INT64_MIN works
+   uint64_t magnitude = negative_ ? 0 - uint64_t(value) : uint64_t(value);
+   while (magnitude != 0)
+   {
+      limbs_.push_back(uint32_t(magnitude));
+      magnitude >>= 32;
+   }
+}
+
+/**
+ * @brief trim
+ * this function removes leading zero limbs and clears the sign of zero
+ */
+void BigInt::trim()
+{
+   while (!limbs_.empty() && limbs_.back() == 0)
+   {
+      limbs_.pop_back();
+   }
+   if (limbs_.empty())
+   {
+      negative_ = false;
+   }
+}
+
+/**
+ * @brief fromString
+ *
+ * @param digits : decimal digits, optionally preceded by a minus sign
+ * @return BigInt : the value of the digits
+ */
+BigInt BigInt::fromString(const string &digits)
+{
+   if (!digits.empty() && digits[0] == '-')
+   {
+      return -fromDigits(digits.data() + 1, digits.size() - 1);
+   }
+   return fromDigits(digits.data(), digits.size());
+}
+
+/**
+ * @brief fromDigits
+ *
+ * @param digits : first of the decimal digits
+ * @param count : number of digits
+ * @return BigInt : the value of the digits
+ */
+BigInt BigInt::fromDigits(const char *digits, size_t count)
+{
+   BigInt result;
+   size_t i = 0;
+
+   // nine digits at a time: result = result * 10^k + chunk
+   while (i < count)
+   {
+      size_t end = min(count, i + 9);
+      uint32_t chunk = 0;
+      uint32_t scale = 1;
+      for (; i < end; i++)
+      {
+         chunk = chunk * 10 + (digits[i] - '0');
+         scale *= 10;
+      }
+      uint64_t carry = chunk;
+      for (size_t j = 0; j < result.limbs_.size(); j++)
+      {
+         uint64_t t = uint64_t(result.limbs_[j]) * scale + carry;
+         result.limbs_[j] = uint32_t(t);
+         carry = t >> 32;
+      }
+      if (carry != 0)
+      {
+         result.limbs_.push_back(uint32_t(carry));
+      }
+   }
+   result.trim();
+   return result;
+}
+
+/**
+ * @brief toString
+ *
+ * @return string : decimal form of the integer
+ */
+string BigInt::toString() const
+{
+   if (limbs_.empty())
+   {
+      return "0";
+   }
+
+   BigInt magnitude = *this;
+   magnitude.negative_ = false;
+
+   // powers[k] = 10^(9 * 2^k), until powers[k]^2 is larger than the value
+   vector<BigInt> powers;
+   powers.push_back(BigInt(1000000000));
+   while (powers.back().bitLength() * 2 <= bitLength() + 1)
+   {
+      powers.push_back(powers.back() * powers.back());
+   }
+
+   string digits = negative_ ? "-" : "";
+   appendDecimal(magnitude, powers, powers.size() - 1, 0, digits);
+   return digits;
+}
+
+/**
+ * @brief appendDecimal
+ * this function appends the decimal digits of a non negative value by
+ * splitting it at powers[k] and converting both halves, so long values
+ * are converted with few long divisions instead of many short ones
+ *
+ * @param value : non negative value to convert
+ * @param powers : powers[k] is 10^(9 * 2^k)
+ * @param k : index of the largest power that may be needed
+ * @param width : number of digits to pad to, 0 for no padding
+ * @param digits : string the digits are appended to
+ */
+void BigInt::appendDecimal(const BigInt &value, const vector<BigInt> &powers,
+                           int k, size_t width, string &digits)
+{
+   if (k < 0 || value.limbs_.size() < karatsubaThreshold)
+   {
+      // peel off nine digits at a time, least significant first
+      vector<uint32_t> magnitude = value.limbs_;
+      vector<uint32_t> chunks;
+      while (!magnitude.empty())
+      {
+         chunks.push_back(divModSmall(magnitude, 1000000000));
+      }
+      string small = chunks.empty() ? "" : to_string(chunks.back());
+      for (size_t i = chunks.size(); i > 1; i--)
+      {
+         string chunk = to_string(chunks[i - 2]);
+         small.append(9 - chunk.size(), '0');
+         small += chunk;
+      }
+      if (width == 0 && small.empty())
+      {
+         small = "0";
+      }
+      if (small.size() < width)
+      {
+         digits.append(width - small.size(), '0');
+      }
+      digits += small;
+      return;
+   }
+
+   BigInt high;
+   BigInt low;
+   divMod(value, powers[k], high, low);
+   size_t lowWidth = size_t(9) << k;
+   if (width == 0 && high.isZero())
+   {
+      appendDecimal(low, powers, k - 1, 0, digits);
+      return;
+   }
+   appendDecimal(high, powers, k - 1, width == 0 ? 0 : width - lowWidth,
+                 digits);
+   appendDecimal(low, powers, k - 1, lowWidth, digits);
+}
+
+/**
+ * @brief fitsInt64
+ *
+ * @return true : if the value can be stored in an int64_t
+ * @return false : if it can not
+ */
+bool BigInt::fitsInt64() const
+{
+   if (limbs_.size() <= 1)
+   {
+      return true;
+   }
+   if (limbs_.size() > 2)
+   {
+      return false;
+   }
+   uint64_t magnitude = (uint64_t(limbs_[1]) << 32) | limbs_[0];
+   return negative_ ? magnitude <= uint64_t(1) << 63
+                    : magnitude < uint64_t(1) << 63;
+}
+
+/**
+ * @brief toInt64
+ * PRE: fitsInt64()
+ *
+ * @return int64_t : the value
+ */
+int64_t BigInt::toInt64() const
+{
+   uint64_t magnitude = 0;
+   for (size_t i = limbs_.size(); i > 0; i--)
+   {
+      magnitude = (magnitude << 32) | limbs_[i - 1];
+   }
+   return negative_ ? int64_t(0 - magnitude) : int64_t(magnitude);
+}
+
+/**
+ * @brief bitLength
+ *
+ * @return size_t : number of bits in the magnitude
+ */
+size_t BigInt::bitLength() const
+{
+   if (limbs_.empty())
+   {
+      return 0;
+   }
+   return limbs_.size() * 32 - __builtin_clz(limbs_.back());
+}
+
+/**
+ * @brief compareMagnitude
+ *
+ * @param a : magnitude
+ * @param b : magnitude
+ * @return int : -1, 0 or 1 as |a| is less, equal or greater than |b|
+ */
+int BigInt::compareMagnitude(const vector<uint32_t> &a,
+                             const vector<uint32_t> &b)
+{
+   if (a.size() != b.size())
+   {
+      return a.size() < b.size() ? -1 : 1;
+   }
+   for (size_t i = a.size(); i > 0; i--)
+   {
+      if (a[i - 1] != b[i - 1])
+      {
+         return a[i - 1] < b[i - 1] ? -1 : 1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * @brief compare
+ *
+ * @param rhs : integer to compare with
+ * @return int : -1, 0 or 1 as this is less, equal or greater than rhs
+ */
+int BigInt::compare(const BigInt &rhs) const
+{
+   if (negative_ != rhs.negative_)
+   {
+      return negative_ ? -1 : 1;
+   }
+   int magnitude = compareMagnitude(limbs_, rhs.limbs_);
+   return negative_ ? -magnitude : magnitude;
+}
+
+/**
+ * @brief addMagnitude
+ *
+ * @param a : magnitude
+ * @param b : magnitude
+ * @return vector<uint32_t> : |a| + |b|
+ */
+vector<uint32_t> BigInt::addMagnitude(const vector<uint32_t> &a,
+                                      const vector<uint32_t> &b)
+{
+   const vector<uint32_t> &longer = a.size() >= b.size() ? a : b;
+   const vector<uint32_t> &shorter = a.size() >= b.size() ? b : a;
+   vector<uint32_t> sum(longer.size() + 1, 0);
+   copy(longer.begin(), longer.end(), sum.begin());
+   addInto(sum.data(), shorter.data(), shorter.size());
+   return sum;
+}
+
+/**
+ * @brief subMagnitude
+ * PRE: |a| >= |b|
+ *
+ * @param a : magnitude
+ * @param b : magnitude
+ * @return vector<uint32_t> : |a| - |b|
+ */
+vector<uint32_t> BigInt::subMagnitude(const vector<uint32_t> &a,
+                                      const vector<uint32_t> &b)
+{
+   vector<uint32_t> difference = a;
+   subInto(difference.data(), b.data(), b.size());
+   return difference;
+}
+
+/**
+ * @brief addInto
+ * this function adds x into out, carrying as far as needed
+ *
+ * @param out : limbs that are added to, must be long enough for the sum
+ * @param x : limbs to add
+ * @param nx : number of limbs in x
+ */
+void BigInt::addInto(uint32_t *out, const uint32_t *x, size_t nx)
+{
+   uint64_t carry = 0;
+   size_t i = 0;
+   for (; i < nx; i++)
+   {
+      uint64_t t = uint64_t(out[i]) + x[i] + carry;
+      out[i] = uint32_t(t);
+      carry = t >> 32;
+   }
+   for (; carry != 0; i++)
+   {
+      uint64_t t = uint64_t(out[i]) + carry;
+      out[i] = uint32_t(t);
+      carry = t >> 32;
+   }
+}
+
+/**
+ * @brief subInto
+ * this function subtracts x from out, borrowing as far as needed
+ * PRE: out >= x
+ *
+ * @param out : limbs that are subtracted from
+ * @param x : limbs to subtract
+ * @param nx : number of limbs in x
+ */
+void BigInt::subInto(uint32_t *out, const uint32_t *x, size_t nx)
+{
+   uint32_t borrow = 0;
+   size_t i = 0;
+   for (; i < nx; i++)
+   {
+      uint64_t t = uint64_t(out[i]) - x[i] - borrow;
+      out[i] = uint32_t(t);
+      borrow = (t >> 32) ? 1 : 0;
+   }
+   for (; borrow != 0; i++)
+   {
+      borrow = out[i] == 0 ? 1 : 0;
+      out[i]--;
+   }
+}
+
+/**
+ * @brief multiply
+ * this function multiplies two magnitudes, using schoolbook
+ * multiplication for short operands and Karatsuba for long ones
+ *
+ * @param a : limbs of first operand
+ * @param na : number of limbs in a
+ * @param b : limbs of second operand
+ * @param nb : number of limbs in b
+ * @param out : na + nb limbs that receive the product
+ */
+void BigInt::multiply(const uint32_t *a, size_t na, const uint32_t *b,
+                      size_t nb, uint32_t *out)
+{
+   if (na < nb)
+   {
+      swap(a, b);
+      swap(na, nb);
+   }
+   fill(out, out + na + nb, 0);
+   if (nb == 0)
+   {
+      return;
+   }
+
+   if (nb < karatsubaThreshold)
+   {
+      for (size_t j = 0; j < nb; j++)
+      {
+         uint64_t carry = 0;
+         for (size_t i = 0; i < na; i++)
+         {
+            uint64_t t = uint64_t(a[i]) * b[j] + out[i + j] + carry;
+            out[i + j] = uint32_t(t);
+            carry = t >> 32;
+         }
+         out[na + j] = uint32_t(carry);
+      }
+      return;
+   }
+
+   if (nb * 2 > na)
+   {
+      karatsuba(a, na, b, nb, out);
+      return;
+   }
+
+   // a is much longer than b, multiply b by slices of a as long as b
+   vector<uint32_t> partial(nb * 2);
+   for (size_t i = 0; i < na; i += nb)
+   {
+      size_t slice = min(nb, na - i);
+      multiply(a + i, slice, b, nb, partial.data());
+      addInto(out + i, partial.data(), slice + nb);
+   }
+}
+
+/**
+ * @brief karatsuba
+ * PRE: na >= nb > na / 2
+ *
+ * @param a : limbs of first operand
+ * @param na : number of limbs in a
+ * @param b : limbs of second operand
+ * @param nb : number of limbs in b
+ * @param out : na + nb limbs that receive the product
+ */
+void BigInt::karatsuba(const uint32_t *a, size_t na, const uint32_t *b,
+                       size_t nb, uint32_t *out)
+{
+   // a = a1 * B^m + a0 and b = b1 * B^m + b0
+   size_t m = na / 2;
+   const uint32_t *a0 = a;
+   const uint32_t *a1 = a + m;
+   const uint32_t *b0 = b;
+   const uint32_t *b1 = b + m;
+   size_t na1 = na - m;
+   size_t nb1 = nb - m;
+
+   vector<uint32_t> z0(m * 2);
+   vector<uint32_t> z2(na1 + nb1);
+   multiply(a0, m, b0, m, z0.data());
+   multiply(a1, na1, b1, nb1, z2.data());
+
+   // z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+   vector<uint32_t> sa(na1 + 1, 0);
+   copy(a1, a1 + na1, sa.begin());
+   addInto(sa.data(), a0, m);
+   vector<uint32_t> sb(max(m, nb1) + 1, 0);
+   copy(b0, b0 + m, sb.begin());
+   addInto(sb.data(), b1, nb1);
+   vector<uint32_t> z1(sa.size() + sb.size());
+   multiply(sa.data(), sa.size(), sb.data(), sb.size(), z1.data());
+   subInto(z1.data(), z0.data(), z0.size());
+   subInto(z1.data(), z2.data(), z2.size());
+
+   // z1 can have zero limbs past the end of the product
+   size_t nz1 = z1.size();
+   while (nz1 > 0 && z1[nz1 - 1] == 0)
+   {
+      nz1--;
+   }
+
+   copy(z0.begin(), z0.end(), out);
+   copy(z2.begin(), z2.end(), out + m * 2);
+   addInto(out + m, z1.data(), nz1);
+}
+
+BigInt BigInt::operator-() const
+{
+   BigInt result = *this;
+   if (!result.limbs_.empty())
+   {
+      result.negative_ = !negative_;
+   }
+   return result;
+}
+
+BigInt BigInt::operator+(const BigInt &rhs) const
+{
+   BigInt result;
+   if (negative_ == rhs.negative_)
+   {
+      result.limbs_ = addMagnitude(limbs_, rhs.limbs_);
+      result.negative_ = negative_;
+   }
+   else if (compareMagnitude(limbs_, rhs.limbs_) >= 0)
+   {
+      result.limbs_ = subMagnitude(limbs_, rhs.limbs_);
+      result.negative_ = negative_;
+   }
+   else
+   {
+      result.limbs_ = subMagnitude(rhs.limbs_, limbs_);
+      result.negative_ = rhs.negative_;
+   }
+   result.trim();
+   return result;
+}
+
+BigInt BigInt::operator-(const BigInt &rhs) const
+{
+   return *this + -rhs;
+}
+
+BigInt BigInt::operator*(const BigInt &rhs) const
+{
+   BigInt result;
+   if (limbs_.empty() || rhs.limbs_.empty())
+   {
+      return result;
+   }
+   result.limbs_.resize(limbs_.size() + rhs.limbs_.size());
+   multiply(limbs_.data(), limbs_.size(), rhs.limbs_.data(),
+            rhs.limbs_.size(), result.limbs_.data());
+   result.negative_ = negative_ != rhs.negative_;
+   result.trim();
+   return result;
+}
+
+/**
+ * @brief divModSmall
+ * this function divides a magnitude by a single limb in place
+ *
+ * @param a : magnitude, replaced by the quotient
+ * @param d : divisor, not zero
+ * @return uint32_t : remainder
+ */
+uint32_t BigInt::divModSmall(vector<uint32_t> &a, uint32_t d)
+{
+   uint64_t remainder = 0;
+   for (size_t i = a.size(); i > 0; i--)
+   {
+      uint64_t t = (remainder << 32) | a[i - 1];
+      a[i - 1] = uint32_t(t / d);
+      remainder = t % d;
+   }
+   while (!a.empty() && a.back() == 0)
+   {
+      a.pop_back();
+   }
+   return uint32_t(remainder);
+}
+
+/**
+ * @brief divModMagnitude
+ * this function divides two magnitudes with Knuth's algorithm D
+ *
+ * @param u : dividend
+ * @param v : divisor, not zero
+ * @param q : quotient
+ * @param r : remainder
+ */
+void BigInt::divModMagnitude(const vector<uint32_t> &u,
+                             const vector<uint32_t> &v,
+                             vector<uint32_t> &q, vector<uint32_t> &r)
+{
+   if (compareMagnitude(u, v) < 0)
+   {
+      q.clear();
+      r = u;
+      return;
+   }
+   if (v.size() == 1)
+   {
+      q = u;
+      uint32_t remainder = divModSmall(q, v[0]);
+      r.clear();
+      if (remainder != 0)
+      {
+         r.push_back(remainder);
+      }
+      return;
+   }
+
+   const uint64_t base = uint64_t(1) << 32;
+   size_t n = v.size();
+   size_t m = u.size() - n;
+
+   // normalize so the top bit of the divisor is set
+   int s = __builtin_clz(v[n - 1]);
+   vector<uint32_t> vn(n);
+   for (size_t i = n - 1; i > 0; i--)
+   {
+      vn[i] = (v[i] << s) | (s ? v[i - 1] >> (32 - s) : 0);
+   }
+   vn[0] = v[0] << s;
+   vector<uint32_t> un(u.size() + 1);
+   un[u.size()] = s ? u[u.size() - 1] >> (32 - s) : 0;
+   for (size_t i = u.size() - 1; i > 0; i--)
+   {
+      un[i] = (u[i] << s) | (s ? u[i - 1] >> (32 - s) : 0);
+   }
+   un[0] = u[0] << s;
+
+   q.assign(m + 1, 0);
+   for (size_t j = m + 1; j > 0; j--)
+   {
+      size_t k = j - 1;
+      // estimate the quotient limb from the top two limbs
+      uint64_t numerator = (uint64_t(un[k + n]) << 32) | un[k + n - 1];
+      uint64_t qhat = numerator / vn[n - 1];
+      uint64_t rhat = numerator % vn[n - 1];
+      while (qhat >= base ||
+             qhat * vn[n - 2] > ((rhat << 32) | un[k + n - 2]))
+      {
+         qhat--;
+         rhat += vn[n - 1];
+         if (rhat >= base)
+         {
+            break;
+         }
+      }
+
+      // multiply and subtract
+      int64_t borrow = 0;
+      int64_t t;
+      for (size_t i = 0; i < n; i++)
+      {
+         uint64_t p = qhat * vn[i];
+         t = int64_t(un[i + k]) - borrow - int64_t(p & 0xFFFFFFFF);
+         un[i + k] = uint32_t(t);
+         borrow = int64_t(p >> 32) - (t >> 32);
+      }
+      t = int64_t(un[k + n]) - borrow;
+      un[k + n] = uint32_t(t);
+
+      q[k] = uint32_t(qhat);
+      if (t < 0)
+      {
+         // the estimate was one too large, add the divisor back
+         q[k]--;
+         uint64_t carry = 0;
+         for (size_t i = 0; i < n; i++)
+         {
+            uint64_t sum = uint64_t(un[i + k]) + vn[i] + carry;
+            un[i + k] = uint32_t(sum);
+            carry = sum >> 32;
+         }
+         un[k + n] += uint32_t(carry);
+      }
+   }
+
+   // unnormalize the remainder
+   r.assign(n, 0);
+   for (size_t i = 0; i < n; i++)
+   {
+      r[i] = (un[i] >> s) | (s ? un[i + 1] << (32 - s) : 0);
+   }
+   while (!q.empty() && q.back() == 0)
+   {
+      q.pop_back();
+   }
+   while (!r.empty() && r.back() == 0)
+   {
+      r.pop_back();
+   }
+}
+
+/**
+ * @brief divMod
+ * this function divides rounding toward zero, so the remainder has the
+ * sign of the dividend
+ *
+ * @param a : dividend
+ * @param b : divisor
+ * @param quotient : a / b
+ * @param remainder : a % b
+ * @return true : if the division could be done
+ * @return false : if b is 0
+ */
+bool BigInt::divMod(const BigInt &a, const BigInt &b, BigInt &quotient,
+                    BigInt &remainder)
+{
+   if (b.limbs_.empty())
+   {
+      return false;
+   }
+   vector<uint32_t> q;
+   vector<uint32_t> r;
+   divModMagnitude(a.limbs_, b.limbs_, q, r);
+   quotient.limbs_.swap(q);
+   quotient.negative_ = a.negative_ != b.negative_;
+   quotient.trim();
+   remainder.limbs_.swap(r);
+   remainder.negative_ = a.negative_;
+   remainder.trim();
+   return true;
+}
+
+/**
+ * @brief pow
+ * this function raises the integer to a power by squaring
+ *
+ * @param exponent : power
+ * @return BigInt : this to the power of exponent
+ */
+BigInt BigInt::pow(uint64_t exponent) const
+{
+   BigInt result = BigInt(1);
+   BigInt base = *this;
+   while (exponent > 0)
+   {
+      if (exponent & 1)
+      {
+         result = result * base;
+      }
+      exponent >>= 1;
+      if (exponent > 0)
+      {
+         base = base * base;
+      }
+   }
+   return result;
+}
+
+/**
+ * @brief shiftRightMagnitude
+ * this function shifts a magnitude right in place
+ *
+ * @param a : magnitude
+ * @param bits : number of bits to shift by
+ */
+void BigInt::shiftRightMagnitude(vector<uint32_t> &a, size_t bits)
+{
+   size_t limbs = bits / 32;
+   int s = bits % 32;
+   if (limbs >= a.size())
+   {
+      a.clear();
+      return;
+   }
+   a.erase(a.begin(), a.begin() + limbs);
+   if (s != 0)
+   {
+      for (size_t i = 0; i + 1 < a.size(); i++)
+      {
+         a[i] = (a[i] >> s) | (a[i + 1] << (32 - s));
+      }
+      a.back() >>= s;
+   }
+   while (!a.empty() && a.back() == 0)
+   {
+      a.pop_back();
+   }
+}
+
+/**
+ * @brief trailingZeros
+ *
+ * @param a : magnitude, not zero
+ * @return size_t : number of zero bits below the lowest set bit
+ */
+size_t BigInt::trailingZeros(const vector<uint32_t> &a)
+{
+   size_t i = 0;
+   while (a[i] == 0)
+   {
+      i++;
+   }
+   return i * 32 + __builtin_ctz(a[i]);
+}
+
+/**
+ * @brief operator<<
+ *
+ * @param bits : number of bits to shift by
+ * @return BigInt : this * 2^bits
+ */
+BigInt BigInt::operator<<(size_t bits) const
+{
+   BigInt result;
+   if (limbs_.empty())
+   {
+      return result;
+   }
+   size_t limbs = bits / 32;
+   int s = bits % 32;
+   result.limbs_.assign(limbs + limbs_.size() + 1, 0);
+   for (size_t i = 0; i < limbs_.size(); i++)
+   {
+      result.limbs_[i + limbs] |= limbs_[i] << s;
+      if (s != 0)
+      {
+         result.limbs_[i + limbs + 1] = limbs_[i] >> (32 - s);
+      }
+   }
+   result.negative_ = negative_;
+   result.trim();
+   return result;
+}
+
+/**
+ * @brief gcd
+ * this function computes the greatest common divisor with the binary
+ * (Stein's) algorithm, which only shifts and subtracts
+ *
+ * @param a : first integer
+ * @param b : second integer
+ * @return BigInt : gcd(|a|, |b|), gcd(0, 0) is 0
+ */
+BigInt BigInt::gcd(const BigInt &a, const BigInt &b)
+{
+   BigInt result;
+   if (a.limbs_.empty() || b.limbs_.empty())
+   {
+      result.limbs_ = a.limbs_.empty() ? b.limbs_ : a.limbs_;
+      return result;
+   }
+
+   if (a.limbs_.size() <= 2 && b.limbs_.size() <= 2)
+   {
+      // both fit in a machine word
+      uint64_t x = a.limbs_[0];
+      uint64_t y = b.limbs_[0];
+      if (a.limbs_.size() == 2)
+      {
+         x |= uint64_t(a.limbs_[1]) << 32;
+      }
+      if (b.limbs_.size() == 2)
+      {
+         y |= uint64_t(b.limbs_[1]) << 32;
+      }
+      int shift = __builtin_ctzll(x | y);
+      x >>= __builtin_ctzll(x);
+      while (y != 0)
+      {
+         y >>= __builtin_ctzll(y);
+         if (x > y)
+         {
+            swap(x, y);
+         }
+         y -= x;
+      }
+      x <<= shift;
+      result.limbs_.push_back(uint32_t(x));
+      result.limbs_.push_back(uint32_t(x >> 32));
+      result.trim();
+      return result;
+   }
+
+   vector<uint32_t> x = a.limbs_;
+   vector<uint32_t> y = b.limbs_;
+   size_t zx = trailingZeros(x);
+   size_t zy = trailingZeros(y);
+   size_t shift = min(zx, zy);
+   shiftRightMagnitude(x, zx);
+   while (!y.empty())
+   {
+      shiftRightMagnitude(y, trailingZeros(y));
+      if (compareMagnitude(x, y) > 0)
+      {
+         x.swap(y);
+      }
+      subInto(y.data(), x.data(), x.size());
+      while (!y.empty() && y.back() == 0)
+      {
+         y.pop_back();
+      }
+   }
+   result.limbs_ = x;
+   return result << shift;
+}
@@ -0,0 +1,314 @@
+/**
+ * @file BigInt.h
+ * @author Katarina McGaughy
+ * @brief The BigInt class is an arbitrary precision integer. The magnitude is
+ * stored in 32 bit limbs with the least significant limb first. Large
+ * products use Karatsuba multiplication and powers use exponentiation by
+ * squaring, so folding large powers and products stays exact.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#pragma once
+using namespace std;
+
+class BigInt
+{
+
+private:
+   // magnitude, least significant limb first, no leading zero limbs
+   vector<uint32_t> limbs_;
+
+   // sign, zero is never negative
+   bool negative_;
+
+   // below this many limbs schoolbook multiplication is faster
+   static const size_t karatsubaThreshold = 32;
+
+   /**
+    * @brief trim
+    * this function removes leading zero limbs and clears the sign of zero
+    */
+   void trim();
+
+   /**
+    * @brief compareMagnitude
+    *
+    * @param a : magnitude
+    * @param b : magnitude
+    * @return int : -1, 0 or 1 as |a| is less, equal or greater than |b|
+    */
+   static int compareMagnitude(const vector<uint32_t> &a,
+                               const vector<uint32_t> &b);
+
+   /**
+    * @brief addMagnitude
+    *
+    * @param a : magnitude
+    * @param b : magnitude
+    * @return vector<uint32_t> : |a| + |b|
+    */
+   static vector<uint32_t> addMagnitude(const vector<uint32_t> &a,
+                                        const vector<uint32_t> &b);
+
+   /**
+    * @brief subMagnitude
+    * PRE: |a| >= |b|
+    *
+    * @param a : magnitude
+    * @param b : magnitude
+    * @return vector<uint32_t> : |a| - |b|
+    */
+   static vector<uint32_t> subMagnitude(const vector<uint32_t> &a,
+                                        const vector<uint32_t> &b);
+
+   /**
+    * @brief addInto
+    * this function adds x into out, carrying as far as needed
+    *
+    * @param out : limbs that are added to, must be long enough for the sum
+    * @param x : limbs to add
+    * @param nx : number of limbs in x
+    */
+   static void addInto(uint32_t *out, const uint32_t *x, size_t nx);
+
+   /**
+    * @brief subInto
+    * this function subtracts x from out, borrowing as far as needed
+    * PRE: out >= x
+    *
+    * @param out : limbs that are subtracted from
+    * @param x : limbs to subtract
+    * @param nx : number of limbs in x
+    */
+   static void subInto(uint32_t *out, const uint32_t *x, size_t nx);
+
+   /**
+    * @brief multiply
+    * this function multiplies two magnitudes, using schoolbook
+    * multiplication for short operands and Karatsuba for long ones
+    *
+    * @param a : limbs of first operand
+    * @param na : number of limbs in a
+    * @param b : limbs of second operand
+    * @param nb : number of limbs in b
+    * @param out : na + nb limbs that receive the product
+    */
+   static void multiply(const uint32_t *a, size_t na, const uint32_t *b,
+                        size_t nb, uint32_t *out);
+
+   /**
+    * @brief karatsuba
+    * PRE: na >= nb > na / 2
+    *
+    * @param a : limbs of first operand
+    * @param na : number of limbs in a
+    * @param b : limbs of second operand
+    * @param nb : number of limbs in b
+    * @param out : na + nb limbs that receive the product
+    */
+   static void karatsuba(const uint32_t *a, size_t na, const uint32_t *b,
+                         size_t nb, uint32_t *out);
+
+   /**
+    * @brief divModSmall
+    * this function divides a magnitude by a single limb in place
+    *
+    * @param a : magnitude, replaced by the quotient
+    * @param d : divisor, not zero
+    * @return uint32_t : remainder
+    */
+   static uint32_t divModSmall(vector<uint32_t> &a, uint32_t d);
+
+   /**
+    * @brief divModMagnitude
+    * this function divides two magnitudes with Knuth's algorithm D
+    *
+    * @param u : dividend
+    * @param v : divisor, not zero
+    * @param q : quotient
+    * @param r : remainder
+    */
+   static void divModMagnitude(const vector<uint32_t> &u,
+                               const vector<uint32_t> &v,
+                               vector<uint32_t> &q, vector<uint32_t> &r);
+
+   /**
+    * @brief shiftRightMagnitude
+    * this function shifts a magnitude right in place
+    *
+    * @param a : magnitude
+    * @param bits : number of bits to shift by
+    */
+   static void shiftRightMagnitude(vector<uint32_t> &a, size_t bits);
+
+   /**
+    * @brief trailingZeros
+    *
+    * @param a : magnitude, not zero
+    * @return size_t : number of zero bits below the lowest set bit
+    */
+   static size_t trailingZeros(const vector<uint32_t> &a);
+
+   /**
+    * @brief appendDecimal
+    * this function appends the decimal digits of a non negative value by
+    * splitting it at powers[k] and converting both halves, so long values
+    * are converted with few long divisions instead of many short ones
+    *
+    * @param value : non negative value to convert
+    * @param powers : powers[k] is 10^(9 * 2^k)
+    * @param k : index of the largest power that may be needed
+    * @param width : number of digits to pad to, 0 for no padding
+    * @param digits : string the digits are appended to
+    */
+   static void appendDecimal(const BigInt &value, const vector<BigInt> &powers,
+                             int k, size_t width, string &digits);
+
+public:
+   /**
+    * @brief Construct a new BigInt object
+    * default constructor, the value is 0
+    */
+   BigInt() : negative_(false) {}
+
+   /**
+    * @brief Construct a new BigInt object
+    *
+    * @param value : value of the integer
+    */
+   BigInt(int64_t value);
+
+   /**
+    * @brief fromString
+    *
+    * @param digits : decimal digits, optionally preceded by a minus sign
+    * @return BigInt : the value of the digits
+    */
+   static BigInt fromString(const string &digits);
+
+   /**
+    * @brief fromDigits
+    * same as above for digits that are read in place, without a sign
+    *
+    * @param digits : first of the decimal digits
+    * @param count : number of digits
+    * @return BigInt : the value of the digits
+    */
+   static BigInt fromDigits(const char *digits, size_t count);
+
+   /**
+    * @brief toString
+    *
+    * @return string : decimal form of the integer
+    */
+   string toString() const;
+
+   /**
+    * @brief fitsInt64
+    *
+    * @return true : if the value can be stored in an int64_t
+    * @return false : if it can not
+    */
+   bool fitsInt64() const;
+
+   /**
+    * @brief toInt64
+    * PRE: fitsInt64()
+    *
+    * @return int64_t : the value
+    */
+   int64_t toInt64() const;
+
+   /**
+    * @brief isZero
+    *
+    * @return true : if the value is 0
+    * @return false : if it is not
+    */
+   bool isZero() const { return limbs_.empty(); }
+
+   /**
+    * @brief isNegative
+    *
+    * @return true : if the value is less than 0
+    * @return false : if it is not
+    */
+   bool isNegative() const { return negative_; }
+
+   /**
+    * @brief isOdd
+    *
+    * @return true : if the lowest bit is set
+    * @return false : if it is not
+    */
+   bool isOdd() const { return !limbs_.empty() && (limbs_[0] & 1); }
+
+   /**
+    * @brief bitLength
+    *
+    * @return size_t : number of bits in the magnitude
+    */
+   size_t bitLength() const;
+
+   /**
+    * @brief compare
+    *
+    * @param rhs : integer to compare with
+    * @return int : -1, 0 or 1 as this is less, equal or greater than rhs
+    */
+   int compare(const BigInt &rhs) const;
+
+   BigInt operator-() const;
+   BigInt operator+(const BigInt &rhs) const;
+   BigInt operator-(const BigInt &rhs) const;
+   BigInt operator*(const BigInt &rhs) const;
+
+   /**
+    * @brief divMod
+    * this function divides rounding toward zero, so the remainder has the
+    * sign of the dividend
+    *
+    * @param a : dividend
+    * @param b : divisor
+    * @param quotient : a / b
+    * @param remainder : a % b
+    * @return true : if the division could be done
+    * @return false : if b is 0
+    */
+   static bool divMod(const BigInt &a, const BigInt &b, BigInt &quotient,
+                      BigInt &remainder);
+
+   /**
+    * @brief operator<<
+    *
+    * @param bits : number of bits to shift by
+    * @return BigInt : this * 2^bits
+    */
+   BigInt operator<<(size_t bits) const;
+
+   /**
+    * @brief gcd
+    * this function computes the greatest common divisor with the binary
+    * (Stein's) algorithm, which only shifts and subtracts
+    *
+    * @param a : first integer
+    * @param b : second integer
+    * @return BigInt : gcd(|a|, |b|), gcd(0, 0) is 0
+    */
+   static BigInt gcd(const BigInt &a, const BigInt &b);
+
+   /**
+    * @brief pow
+    * this function raises the integer to a power by squaring
+    *
+    * @param exponent : power
+    * @return BigInt : this to the power of exponent
+    */
+   BigInt pow(uint64_t exponent) const;
+};
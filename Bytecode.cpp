@@ -0,0 +1,213 @@
+/**
+ * @file Bytecode.cpp
+ * @author Katarina McGaughy
+ * @brief The Bytecode class is an AST compiled into a linear list of
+ * instructions for a small stack machine. The code is compiled once and can
+ * then be run any number of times without walking the tree.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Bytecode.h"
+#include <utility>
+using namespace std;
+
+/**
+ * @brief Construct a new Bytecode object
+ * this constructor compiles the tree of an AST
+ *
+ * @param ast : AST to compile
+ */
+Bytecode::Bytecode(const AST &ast) : valid_(false)
+{
+   compile(ast);
+}
+
+/**
+ * @brief compile
+ * this function compiles the tree of an AST, replacing the code it held. A
+ * post order walk emits the operands of an operator before the operator,
+ * and the height of the stack is tracked so the operand stack can be
+ * allocated once. The vectors keep their memory from one tree to the next.
+ *
+ * @param ast : AST to compile
+ */
+void Bytecode::compile(const AST &ast)
+{
+   code_.clear();
+   constants_.clear();
+   variables_.clear();
+   valid_ = false;
+   if (ast.root_ == nullptr)
+   {
+      return;
+   }
+
+   size_t height = 0;
+   size_t maxHeight = 0;
+   walk_.clear();
+   walk_.push_back(make_pair(ast.root_, false));
+   while (!walk_.empty())
+   {
+      const AST::Node *node = walk_.back().first;
+      bool visited = walk_.back().second;
+      walk_.pop_back();
+      if (!visited && node->left != nullptr)
+      {
+         walk_.push_back(make_pair(node, true));
+         walk_.push_back(make_pair(node->right, false));
+         walk_.push_back(make_pair(node->left, false));
+         continue;
+      }
+
+      Instruction instruction;
+      const Token &t = node->token;
+      if (t.type_ == number)
+      {
+         if (node->big != nullptr)
+         {
+            // values that do not fit are left to the tree
+            code_.clear();
+            return;
+         }
+         instruction.op = bcPushConst;
+         instruction.arg = constants_.size();
+         constants_.push_back(t.number_);
+         height++;
+      }
+      else if (t.type_ == variable)
+      {
+         instruction.op = bcLoadVar;
+         instruction.arg = slotOf(t.id_);
+         height++;
+      }
+      else
+      {
+         switch (t.op_)
+         {
+         case opAdd:
+            instruction.op = bcAdd;
+            break;
+         case opSub:
+            instruction.op = bcSub;
+            break;
+         case opMul:
+            instruction.op = bcMul;
+            break;
+         case opDiv:
+            instruction.op = bcDiv;
+            break;
+         default:
+            instruction.op = bcPow;
+            break;
+         }
+         instruction.arg = 0;
+         height--;
+      }
+      code_.push_back(instruction);
+      if (height > maxHeight)
+      {
+         maxHeight = height;
+      }
+   }
+   // shrinking keeps the memory, so this only allocates for a deeper tree
+   stack_.resize(maxHeight);
+   valid_ = true;
+}
+
+/**
+ * @brief slotOf
+ * this function returns the slot of a variable, adding a slot the first
+ * time the variable is seen
+ *
+ * @param id : interned id of the variable
+ * @return uint32_t : index of the slot
+ */
+uint32_t Bytecode::slotOf(uint32_t id)
+{
+   for (uint32_t i = 0; i < variables_.size(); i++)
+   {
+      if (variables_[i] == id)
+      {
+         return i;
+      }
+   }
+   variables_.push_back(id);
+   return variables_.size() - 1;
+}
+
+/**
+ * @brief run
+ * this function runs the code on machine integers. It stops as soon as a
+ * calculation cannot be done exactly, so the caller can fall back to the
+ * tree.
+ * PRE: valid()
+ *
+ * @param values : value of each slot
+ * @param result : value of the expression
+ * @return true : if every calculation was exact
+ * @return false : if a calculation overflowed, divided by zero or had a
+ * fraction as result
+ */
+bool Bytecode::run(const int64_t *values, int64_t &result) const
+{
+   int64_t *stack = stack_.data();
+   const int64_t *constants = constants_.data();
+   // index of the next free entry of the stack
+   size_t top = 0;
+   const Instruction *end = code_.data() + code_.size();
+   for (const Instruction *ip = code_.data(); ip != end; ip++)
+   {
+      switch (ip->op)
+      {
+      case bcPushConst:
+         stack[top++] = constants[ip->arg];
+         break;
+      case bcLoadVar:
+         stack[top++] = values[ip->arg];
+         break;
+      case bcAdd:
+         top--;
+         if (__builtin_add_overflow(stack[top - 1], stack[top],
+                                    &stack[top - 1]))
+         {
+            return false;
+         }
+         break;
+      case bcSub:
+         top--;
+         if (__builtin_sub_overflow(stack[top - 1], stack[top],
+                                    &stack[top - 1]))
+         {
+            return false;
+         }
+         break;
+      case bcMul:
+         top--;
+         if (__builtin_mul_overflow(stack[top - 1], stack[top],
+                                    &stack[top - 1]))
+         {
+            return false;
+         }
+         break;
+      case bcDiv:
+         top--;
+         if (!AST::calc(stack[top - 1], opDiv, stack[top], stack[top - 1]))
+         {
+            return false;
+         }
+         break;
+      case bcPow:
+         top--;
+         if (!AST::calc(stack[top - 1], opPow, stack[top], stack[top - 1]))
+         {
+            return false;
+         }
+         break;
+      }
+   }
+   result = stack[0];
+   return true;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file Bytecode.h
+ * @author Katarina McGaughy
+ * @brief The Bytecode class is an AST compiled into a linear list of
+ * instructions for a small stack machine. Numbers are pushed from a table of
+ * constants, variables are loaded from slots that are bound when the code is
+ * run and every operator pops two values and pushes one. The code is
+ * compiled once and can then be run any number of times without walking
+ * the tree.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "AST.h"
+#pragma once
+using namespace std;
+
+/**
+ * @brief ByteOp
+ * Enum of the instructions of the stack machine
+ */
+enum ByteOp : unsigned char
+{
+   bcPushConst,
+   bcLoadVar,
+   bcAdd,
+   bcSub,
+   bcMul,
+   bcDiv,
+   bcPow
+};
+
+class Bytecode
+{
+   // the batch evaluator runs the same instructions on columns of values
+   friend class BatchEval;
+
+private:
+   /**
+    * @brief Instruction
+    * an instruction and its argument, the index of a constant for
+    * bcPushConst and the index of a slot for bcLoadVar
+    */
+   struct Instruction
+   {
+      ByteOp op;
+      uint32_t arg;
+   };
+
+   // instructions in the order they are run
+   vector<Instruction> code_;
+
+   // values pushed by bcPushConst
+   vector<int64_t> constants_;
+
+   // interned id of the variable bound to each slot
+   vector<uint32_t> variables_;
+
+   // operand stack, allocated once with the deepest size the code needs
+   mutable vector<int64_t> stack_;
+
+   // false if the tree holds a value that does not fit in an int64_t
+   bool valid_;
+
+   // nodes left to visit while compiling and whether their operands were
+   // pushed, kept so compiling again does not allocate
+   vector<pair<const AST::Node *, bool> > walk_;
+
+   /**
+    * @brief slotOf
+    * this function returns the slot of a variable, adding a slot the first
+    * time the variable is seen
+    *
+    * @param id : interned id of the variable
+    * @return uint32_t : index of the slot
+    */
+   uint32_t slotOf(uint32_t id);
+
+public:
+   /**
+    * @brief Construct a new Bytecode object
+    * default constructor, the code is empty and not valid
+    */
+   Bytecode() : valid_(false) {}
+
+   /**
+    * @brief Construct a new Bytecode object
+    * this constructor compiles the tree of an AST
+    *
+    * @param ast : AST to compile
+    */
+   explicit Bytecode(const AST &ast);
+
+   /**
+    * @brief compile
+    * this function compiles the tree of an AST, replacing the code it held.
+    * The vectors keep their memory, so a Bytecode that is compiled for
+    * every line only allocates for a line longer than the ones before.
+    *
+    * @param ast : AST to compile
+    */
+   void compile(const AST &ast);
+
+   /**
+    * @brief valid
+    *
+    * @return true : if the code can be run
+    * @return false : if the tree was empty or held a value that does not fit
+    * in an int64_t
+    */
+   bool valid() const { return valid_; }
+
+   /**
+    * @brief variables
+    *
+    * @return const vector<uint32_t>& : interned id of the variable of each
+    * slot, in slot order
+    */
+   const vector<uint32_t> &variables() const { return variables_; }
+
+   /**
+    * @brief size
+    *
+    * @return size_t : number of instructions
+    */
+   size_t size() const { return code_.size(); }
+
+   /**
+    * @brief run
+    * this function runs the code on machine integers. It stops as soon as a
+    * calculation cannot be done exactly, so the caller can fall back to the
+    * tree.
+    * PRE: valid()
+    *
+    * @param values : value of each slot
+    * @param result : value of the expression
+    * @return true : if every calculation was exact
+    * @return false : if a calculation overflowed, divided by zero or had a
+    * fraction as result
+    */
+   bool run(const int64_t *values, int64_t &result) const;
+};
@@ -15,6 +15,10 @@
  */
 #include "Calc.h"
 #include "AST.h"
+#include "FlatAST.h"
+#include "LineReader.h"
+#include "Validator.h"
+#include <cstring>
 #include <iostream>
 #include <stack>
 #include <vector>
@@ -23,26 +27,24 @@ using namespace std;
 
 /**
  * @brief Construct a new Calc object
- * initializes istream and the map of variables
+ * initializes istream and the table of variables, a variable stands for
+ * itself until it is assigned
+ *
+ * @param mode : how the trees of the expressions are stored
+ * @param parse : how the lines are parsed
  */
-Calc::Calc() : tstream(cin), variables()
+Calc::Calc(StorageMode mode, ParseMode parse, PrintMode print)
+    : tstream(cin), variables(), mode_(mode), parser_(parse), print_(print)
 {
-   initializeVariables();
 }
 
 /**
  * @brief calculate
  * this function continuously asks the user for input until a . is entered.
- * It stores the tokens from input into a vector and then checks to ensure
- * that the input is a valid infix expression via the isValid() function.
- * If it is not, it will display an error message and continue to get input
- * from user. If it is a valid expression, the expression is checked to see
- * if it is an assignment. If it is an assignment, a new infix vector is
- * formed without the variable and expression operator and then saved in the
- * map of variables. The infix is converted to postfix via the
- * convertPostFix() function. From there, an AST is created by passing
- * in the postfix vector of tokens along with the map that holds
- * the variables and their assignments.
+ * The Parser reads the tokens of each line, checks that they are a valid
+ * infix expression and builds its AST in one pass. If it is not, it will
+ * display an error message and continue to get input from user. If the line
+ * is an assignment, the tree is saved in the table of variables.
  * The AST is then simplified via the simplify() function and the solution is
  * printed to the screen via the toInfix() function. The user can continue to
  * enter expressions after this until the end condition is met.
@@ -58,555 +60,212 @@ void Calc::calculate()
    // keep calculating expressions until done
    while (!done)
    {
-      Token tok = Token();
-      vector<Token> infix;
       TokenStream tstream(cin);
+      shared_ptr<Arena> arena = nextScratchArena();
+      AST ast = AST(arena);
+      string expr;
 
-      // while not at end of line
-      while (tok.type_ != eol)
+      // read, check and build the line in one pass
+      if (parser_.parse(tstream, ast, &expr))
       {
-         // read in tokens from stream and add to infix vector
-         tstream >> tok;
-         infix.push_back(tok);
+         // add expression to vector to print later
+         expressions.push_back(expr);
+         solutions.push_back(string());
+         solve(ast, arena, solutions.back());
       }
-
       // if the first token is ending token, end program
-      if (infix[0].type_ == ending)
+      else if (parser_.endOfInput())
       {
          cout << "Exiting calculator." << endl;
          displayInputAndOutput(expressions, solutions);
          done = true;
       }
-
-      // if infix is a valid expression, convert to postfix vector
-      if (isValid(infix))
-      {
-         string expr;
-         for (int i = 0; i < infix.size(); i++)
-         {
-            expr += infix[i].value_;
-         }
-         // add expression to vector to print later
-         expressions.push_back(expr);
-
-         // if it is an assignment, store expression in variable
-         if (isAnAssignment(infix))
-         {
-            vector<Token> postfix;
-            postfix = assignVariableHelper(infix);
-            AST ast = AST(postfix);
-            // Make a copy of the original AST to simplify.
-            AST simplifiedAST = ast.simplify(variables);
-            string sol = ast.toInfix(simplifiedAST);
-            solutions.push_back(sol);
-         }
-         else if (infix[0].type_ == variable && infix[1].type_ == eol)
-         {
-            // add variable again to assignopp and then add assignop to vector
-            AST ast = AST(infix);
-            Token t = Token(assignop, ":=");
-            infix.insert(infix.begin(), t);
-            infix.insert(infix.begin(), infix[0]);
-            vector<Token> postfix;
-            postfix = assignVariableHelper(infix);
-            // Make a copy of the original AST to simplify.
-            AST simplifiedAST = ast.simplify(variables);
-            string sol = ast.toInfix(simplifiedAST);
-            solutions.push_back(sol);
-         }
-         else
-         {
-            vector<Token> postfix;
-            postfix = convertPostfix(infix);
-            AST ast = AST(postfix);
-            AST simplifiedAST = ast.simplify(variables);
-            string sol = ast.toInfix(simplifiedAST);
-            solutions.push_back(sol);
-         }
-      }
-   }
-}
-
-/**
- * @brief displayInputAndOutput
- * this function takes in two vectors of strings that hold the input and
- * output and print them.
- *
- * @param expressions : expressions that were input to calculator
- * @param solutions : solutions of the expressions
- */
-void Calc::displayInputAndOutput(vector<string> &expressions,
-                                 vector<string> &solutions) const
-{
-   cout << "Displaying all input and output below: " << endl;
-   for (int i = 0; i < expressions.size(); i++)
-   {
-      cout << "in  [" << i << "]: ";
-      cout << expressions[i];
-      cout << "out [" << i << "]: ";
-      cout << solutions[i] << endl;
-   }
-}
-
-/**
- * @brief initializeVariables
- * this functions initializes the map of variables to an AST that is just
- * a token with a type of variable and value that is a character from the
- * alphabet
- *
- */
-void Calc::initializeVariables()
-{
-   string alph = "abcdefghijklmnopqrstuvwxyz";
-   for (int i = 0; i < alph.length(); i++)
-   {
-      string var;
-      var = alph[i];
-      Token t = Token(variable, var);
-      AST ast = AST(t);
-      variables.insert(pair<string, AST>(var, ast));
-   }
-}
-
-/**
- * @brief assignVariableHelper
- * this function creates a new infix vector without variable and assignment
- * operator and then converts the infix vector to postfix. It then calls
- * assignVariable
- *
- * @param infix
- * @param variables
- * @return vector<Token>
- */
-vector<Token> Calc::assignVariableHelper(vector<Token> &infix)
-{
-   string variable = infix[0].value_;
-
-   infix.erase(infix.begin());
-   infix.erase(infix.begin());
-   vector<Token> postfix = convertPostfix(infix);
-   // add the variable along with the AST to the map of variables
-   assignVariable(variable, postfix);
-   return postfix;
-}
-
-/**
- * @brief assignVariable
- * this function takes in the map of variables and the postfix expression
- * and assigns the AST created from the postfix expression to the variable
- *
- * @param v : string variable
- * @param variables : map of variables
- * @param postfix : postfix vector
- */
-void Calc::assignVariable(string v,
-                          vector<Token> &postfix)
-{
-   if (postfix.size() == 2)
-   {
-      return;
    }
-   // if variable exists, delete and store new AST
-   map<string, AST>::iterator it = variables.find(v);
-   if (it != variables.end())
-   {
-      variables.erase(it);
-   }
-   AST variableAST = AST(postfix);
-   // store AST
-   variables.insert(pair<string, AST>(v, variableAST));
 }
 
 /**
- * @brief isAnAssignment
+ * @brief calculateBatch
+ * this function runs a script through the calculator without a prompt.
+ * The script is read in large blocks and split into lines, and the
+ * solution of each line is written as soon as it is known, so nothing is
+ * kept from one line to the next except the variables. The script ends at
+ * a line that is a . or at the end of the stream.
  *
- * @param postfix : takes in an infix vector
- * @return true : if the vector is an assignment
- * @return false : if it is not an assignment
+ * @param in : stream the script is read from
+ * @param out : stream the solutions are written to, one per line
  */
-bool Calc::isAnAssignment(vector<Token> &infix) const
+void Calc::calculateBatch(istream &in, ostream &out)
 {
-   if (infix[0].type_ == variable && infix[1].type_ == assignop)
+   LineReader lines(in);
+   const char *begin;
+   const char *end;
+   while (lines.next(begin, end))
    {
-      return true;
-   }
-   return false;
-}
-
-/**
- * @brief isValid
- * this functions checks to ensure that the infix vector of tokens is a valid
- * expression by calling various functions
- *
- * @param infix : infix vector of tokens
- * @return true : if expression is valid
- * @return false : if it is not valid
- */
-bool Calc::isValid(vector<Token> &infix) const
-{
-   if (isValidToken(infix) && isValidFirstToken(infix) &&
-                   isValidLastToken(infix) && isValidSize(infix) &&
-                   isValidBinop(infix) &&
-                   isValidAssignop(infix) && isValidEol(infix) &&
-                   isValidLParen(infix) &&
-                   isValidNumber(infix) && isValidPowop(infix) &&
-                   isValidRParen(infix)){
-                      return true;
-                   }
-
-   return false;
-}
-
-/**
- * @brief isValidToken
- *
- * @param infix
- * @return true : if is a valid token
- * @return false : if not
- */
-bool Calc::isValidToken(vector<Token> &infix) const
-{
-   for (int i = 0; i < infix.size(); i++)
-   {
-      if (infix[i].type_ == invalid)
+      if (!calculateScriptLine(begin, end, out))
       {
-         cout << "Invalid character entered." << endl;
-         cout << "Please enter a valid expression." << endl;
-         return false;
+         break;
       }
    }
-   return true;
+   out.flush();
 }
 
 /**
- * @brief isValidFirstToken
+ * @brief calculateBatch
+ * same as above for a script that is already in memory, such as a mapped
+ * file. The lines are found with memchr, which scans a vector of bytes at a
+ * time, and each line is lexed where it lies.
  *
- * @param infix : infix vector of tokens
- * @return true : if the first token is a valid type
- * @return false : if not valid
+ * @param begin : first character of the script
+ * @param end : one past the last character of the script
+ * @param out : stream the solutions are written to, one per line
  */
-bool Calc::isValidFirstToken(vector<Token> &infix) const
+void Calc::calculateBatch(const char *begin, const char *end, ostream &out)
 {
-   for (int i = 0; i < infix.size(); i++)
+   while (begin != end)
    {
-      if (infix[0].type_ == variable || infix[0].type_ == number ||
-          infix[0].type_ == lparen)
+      const char *newline = static_cast<const char *>(
+          memchr(begin, '\n', end - begin));
+      // a last line without a '\n' ends at the end of the script
+      const char *next = newline == nullptr ? end : newline + 1;
+      if (!calculateScriptLine(begin, next, out))
       {
-         return true;
+         break;
       }
-      else
-      {
-         return false;
-      }
-   }
-   return true;
-}
-
-/**
- * @brief isValidLastToken
- *
- * @param infix : infix vector of tokens
- * @return true : if the last token is a valid type
- * @return false : if not
- */
-bool Calc::isValidLastToken(vector<Token> &infix) const
-{
-   if (infix[infix.size() - 1].type_ == eol)
-   {
-      return true;
-   }
-   else
-   {
-      cout << "Invalid last token." << endl;
-      return false;
-   }
-   return true;
-}
-
-/**
- * @brief isValidSize
- *
- * @param infix : infix vector of tokens
- * @return true : if the size of the vector is less than 80 tokens
- * @return false : if it is larger than 80 tokens
- */
-bool Calc::isValidSize(vector<Token> &infix) const
-{
-   if (infix.size() > 80)
-   {
-      cerr << "Error, input must be no longer than 80 tokens." << endl;
-      return false;
+      begin = next;
    }
-   return true;
+   out.flush();
 }
 
 /**
- * @brief isValidBinop
+ * @brief calculateScriptLine
+ * this function solves one line of a script and writes its solution
  *
- * @param infix : infix vector of tokens
- * @return true : if the token after binop is allowed
- * @return false : if it is not allowed
+ * @param begin : first character of the line
+ * @param end : one past the last character of the line
+ * @param out : stream the solution is written to
+ * @return true : if the script goes on
+ * @return false : if the line is a .
  */
-bool Calc::isValidBinop(vector<Token> &infix) const
+bool Calc::calculateScriptLine(const char *begin, const char *end,
+                               ostream &out)
 {
-   for (int i = 0; i < infix.size(); i++)
-   {
-      if (i + 1 <= infix.size())
-      {
-         if (infix[i].type_ == binop)
-         {
-            if (infix[i + 1].type_ == variable || infix[i + 1].type_ == number || infix[i + 1].type_ == lparen)
-            {
-               return true;
-            }
-            else
-            {
-               cout << "Invalid character after operator." << endl;
-               return false;
-            }
-         }
-      }
-   }
-   return true;
-}
+   // the line is lexed where it lies in memory
+   TokenStream tstream(begin, end);
+   shared_ptr<Arena> arena = nextScratchArena();
+   AST ast = AST(arena);
 
-/**
- * @brief isValidVariable
- *
- * @param infix : infix vector of tokens
- * @return true : if the token after variable is allowed
- * @return false : if it is not allowed
- */
-bool Calc::isValidVariable(vector<Token> &infix) const
-{
-   for (int i = 0; i < infix.size(); i++)
+   if (parser_.parse(tstream, ast))
    {
-      if (i + 1 <= infix.size())
-      {
-         if (infix[i].type_ == variable)
-         {
-            if (infix[i + 1].type_ == binop || infix[i + 1].type_ == rparen || infix[i + 1].type_ == powop ||
-                infix[i + 1].type_ == assignop ||
-                infix[i + 1].type_ == eol)
-            {
-               return true;
-            }
-            else
-            {
-               cout << "Invalid character after variable." << endl;
-               return false;
-            }
-         }
-      }
+      solution_.clear();
+      solve(ast, arena, solution_);
+      solution_ += '\n';
+      out.write(solution_.data(), solution_.size());
    }
-   return true;
+   return !parser_.endOfInput();
 }
 
 /**
- * @brief isValidNumber
+ * @brief solve
+ * this function solves the tree of a valid line in the storage mode of the
+ * calculator and appends the solution in infix form to a string. If the
+ * line is an assignment the tree is stored in its variable first.
  *
- * @param infix : infix vector of tokens
- * @return true : if token after number is allowed
- * @return false : if it is not allowed
+ * @param ast : tree of the line
+ * @param arena : arena for the trees of this line
+ * @param solution : string the simplified expression is appended to
  */
-bool Calc::isValidRParen(vector<Token> &infix) const
+void Calc::solve(AST &ast, const shared_ptr<Arena> &arena, string &solution)
 {
-   for (int i = 0; i < infix.size(); i++)
+   if (parser_.assignment())
    {
-      if (i + 1 <= infix.size())
-      {
-         if (infix[i].type_ == rparen)
-         {
-            if (infix[i + 1].type_ == binop || infix[i + 1].type_ == rparen ||
-                infix[i + 1].type_ == powop ||
-                infix[i + 1].type_ == eol)
-            {
-               return true;
-            }
-            else
-            {
-               cout << "Invalid character after right parenthesis." << endl;
-               return false;
-            }
-         }
-      }
+      assignVariable(parser_.target(), ast);
    }
-   return true;
-}
-
-/**
- * @brief isValidPowop
- *
- * @param infix : infix vector of tokens
- * @return true : if the token after the power operator is valid
- * @return false : if it is not valid
- */
-bool Calc::isValidNumber(vector<Token> &infix) const
-{
-   for (int i = 0; i < infix.size(); i++)
+   // Make a copy of the original AST to simplify.
+   AST simplifiedAST = ast.simplify(variables, bytecode_, arena);
+   if (mode_ == flatStorage)
    {
-      if (i + 1 <= infix.size())
-      {
-         if (infix[i].type_ == number)
-         {
-            if (infix[i + 1].type_ == binop || infix[i + 1].type_ == rparen ||
-                infix[i + 1].type_ == powop ||
-                infix[i + 1].type_ == eol)
-            {
-               return true;
-            }
-            else
-            {
-               cout << "Invalid character after number." << endl;
-               return false;
-            }
-         }
-      }
+      // the solution is the same in both storages, only the tree that is
+      // printed is stored as a vector
+      FlatAST(simplifiedAST).toInfix(solution, print_);
+      return;
    }
-   return true;
+   simplifiedAST.toInfix(solution, print_);
 }
 
 /**
- * @brief isValidAssignop
+ * @brief nextScratchArena
+ * this function returns the arena for the trees of the next expression.
+ * The arena is reset and reused if no tree still refers to it.
  *
- * @param infix : infix vector of tokens
- * @return true : if the token after assignop is allowed
- * @return false : if it is not allowed
+ * @return shared_ptr<Arena> : arena for the next expression
  */
-bool Calc::isValidPowop(vector<Token> &infix) const
-{
-   for (int i = 0; i < infix.size(); i++)
-   {
-      if (i + 1 <= infix.size())
-      {
-         if (infix[i].type_ == powop)
-         {
-            if (infix[i + 1].type_ == number)
-            {
-               return true;
-            }
-            if (infix[i + 1].type_ == lparen)
-            {
-               return isValidPowHelper(infix, i+1);
-            }
-            else
-            {
-               cout << "Invalid character after power operator." << endl;
-               return false;
-            }
-         }
-      }
-   }
-   return true;
-}
-
-bool Calc::isValidPowHelper(vector<Token> &infix, int lparen) const
+shared_ptr<Arena> Calc::nextScratchArena()
 {
-   int rparen;
-   for (int j = lparen + 1; j <= infix.size(); j++)
+   if (scratch_ != nullptr && scratch_.use_count() == 1)
    {
-      if (infix[j].type_ == rparen)
-      {
-         j = rparen;
-      }
+      scratch_->reset();
    }
-   for (int j = lparen + 1; j <= rparen; j++)
+   else
    {
-      if (infix[j].type_ == variable)
-      {
-         cout << "Invalid character after power operator." << endl;
-         return false;
-      }
+      scratch_ = make_shared<Arena>();
    }
-   return true;
+   return scratch_;
 }
 
 /**
- * @brief isValidEol
+ * @brief displayInputAndOutput
+ * this function takes in two vectors of strings that hold the input and
+ * output and print them.
  *
- * @param infix : infix vector of tokens
- * @return true : if the eol is at the end of the expression
- * @return false : if it is not at end of expression
+ * @param expressions : expressions that were input to calculator
+ * @param solutions : solutions of the expressions
  */
-bool Calc::isValidAssignop(vector<Token> &infix) const
+void Calc::displayInputAndOutput(vector<string> &expressions,
+                                 vector<string> &solutions) const
 {
-   for (int i = 0; i < infix.size(); i++)
+   cout << "Displaying all input and output below: " << endl;
+   for (int i = 0; i < expressions.size(); i++)
    {
-      if (i + 1 < infix.size())
-      {
-         if (infix[i].type_ == assignop)
-         {
-            if (infix[i + 1].type_ == number || infix[i + 1].type_ == lparen ||
-                infix[i + 1].type_ == variable)
-            {
-               return true;
-            }
-            else
-            {
-               cout << "Invalid character after assignment operator." << endl;
-               return false;
-            }
-         }
-      }
+      cout << "in  [" << i << "]: ";
+      cout << expressions[i];
+      cout << "out [" << i << "]: ";
+      cout << solutions[i] << endl;
    }
-   return true;
 }
 
 /**
- * @brief
+ * @brief assignVariable
+ * this function stores the tree of an expression in a variable. The tree is
+ * copied into an arena of its own, so the arena of the line can be reused,
+ * and the copy is moved into the table. The values kept for the variables
+ * that depend on the variable are dropped, the others are kept.
  *
- * @param infix : infix vector of tokens
- * @return true : if the token after the rparen is valid
- * @return false if it is not allowed
+ * @param id : interned id of the variable
+ * @param ast : tree of the expression assigned to the variable
  */
-bool Calc::isValidEol(vector<Token> &infix) const
+void Calc::assignVariable(uint32_t id, const AST &ast)
 {
-   for (int i = 0; i < infix.size(); i++)
-   {
-      if (infix[i].type_ == eol)
-      {
-         if (i == infix.size() - 1)
-         {
-            return true;
-         }
-         else
-         {
-            cout << "Invalid character after power operator." << endl;
-         }
-      }
-   }
-   return true;
+   variables.assign(id, AST(ast, make_shared<Arena>(4096)));
 }
 
 /**
- * @brief
+ * @brief isValid
+ * this functions checks to ensure that the infix vector of tokens is a valid
+ * expression in one pass, reporting every error of the line with its
+ * column
  *
  * @param infix : infix vector of tokens
- * @return true : if the token after lparen is valid
- * @return false : if it is not allowed
+ * @return true : if expression is valid
+ * @return false : if it is not valid
  */
-bool Calc::isValidLParen(vector<Token> &infix) const
+bool Calc::isValid(vector<Token> &infix) const
 {
+   Validator validator;
    for (int i = 0; i < infix.size(); i++)
    {
-      if (i + 1 <= infix.size())
-      {
-         if (infix[i].type_ == lparen)
-         {
-            if (infix[i + 1].type_ == number || infix[i + 1].type_ == lparen ||
-                infix[i + 1].type_ == variable)
-            {
-               return true;
-            }
-            else
-            {
-               cout << "Invalid character after left parenthesis." << endl;
-               return false;
-            }
-         }
-      }
+      validator.accept(infix[i]);
    }
-   return true;
+   return validator.finish();
 }
 
 /**
@@ -617,24 +276,9 @@ bool Calc::isValidLParen(vector<Token> &infix) const
  * @param t : token
  * @return int : precedence rank
  */
-int Calc::precedence(Token t) const
+int Calc::precedence(const Token &t) const
 {
-   if (t.type_ == powop)
-   {
-      return 3;
-   }
-   else if (t.value_ == "/" || t.value_ == "*")
-   {
-      return 2;
-   }
-   else if (t.value_ == "+" || t.value_ == "-")
-   {
-      return 1;
-   }
-   else
-   {
-      return -1;
-   }
+   return opcodePrecedence(t.op_);
 }
 
 /**
@@ -644,7 +288,7 @@ int Calc::precedence(Token t) const
  * @return true : if is a left parenthesis
  * @return false : if not
  */
-bool Calc::isLeftParen(Token t) const
+bool Calc::isLeftParen(const Token &t) const
 {
    if (t.type_ == lparen)
    {
@@ -660,7 +304,7 @@ bool Calc::isLeftParen(Token t) const
  * @return true : if is a right parenthesis
  * @return false : false if not
  */
-bool Calc::isRightParen(Token t) const
+bool Calc::isRightParen(const Token &t) const
 {
    if (t.type_ == rparen)
    {
@@ -678,7 +322,7 @@ bool Calc::isRightParen(Token t) const
  * @return true : returns true if first token has precedence
  * @return false : false if not
  */
-bool Calc::hasPrecedence(Token tok1, Token tok2) const
+bool Calc::hasPrecedence(const Token &tok1, const Token &tok2) const
 {
    int t1 = precedence(tok1);
    int t2 = precedence(tok2);
@@ -700,7 +344,7 @@ bool Calc::hasPrecedence(Token tok1, Token tok2) const
  * @param t : token
  * @return int : returns true if right associative (^)
  */
-bool Calc::isRightAssoc(Token t) const
+bool Calc::isRightAssoc(const Token &t) const
 {
    if (t.type_ == powop)
       return true;
@@ -726,8 +370,6 @@ vector<Token> Calc::convertPostfix(const vector<Token> &infix)
    for (int i = 0; i < infix.size(); i++)
    {
 
-      Token t = infix[i];
-
       if (infix[i].type_ == number || infix[i].type_ == variable)
       {
          postfix.push_back(infix[i]);
@@ -19,8 +19,23 @@
 #include "TokenStream.h"
 #include "Token.h"
 #include "AST.h"
+#include "Bytecode.h"
+#include "Parser.h"
+#include "SymbolTable.h"
 #include <map>
 
+/**
+ * @brief StorageMode
+ * Enum that selects how the calculator stores the trees of the expressions,
+ * either as nodes linked by pointers (AST) or as a vector of nodes in postfix
+ * order (FlatAST)
+ */
+enum StorageMode
+{
+   treeStorage,
+   flatStorage
+};
+
 class Calc
 {
 
@@ -28,8 +43,13 @@ public:
    /**
     * @brief Construct a new Calc object
     * initializes istream and the map of variables
+    *
+    * @param mode : how the trees of the expressions are stored
+    * @param parse : how the lines are parsed
+    * @param print : how many parentheses the solutions are printed with
     */
-   Calc();
+   Calc(StorageMode mode = treeStorage, ParseMode parse = shuntingYard,
+        PrintMode print = fullParentheses);
 
    /**
     * @brief Destroy the Calc object
@@ -57,6 +77,30 @@ public:
     */
    void calculate();
 
+   /**
+    * @brief calculateBatch
+    * this function runs a script through the calculator without a prompt.
+    * The script is read in large blocks and split into lines, and the
+    * solution of each line is written as soon as it is known, so nothing is
+    * kept from one line to the next except the variables. The script ends at
+    * a line that is a . or at the end of the stream.
+    *
+    * @param in : stream the script is read from
+    * @param out : stream the solutions are written to, one per line
+    */
+   void calculateBatch(istream &in, ostream &out);
+
+   /**
+    * @brief calculateBatch
+    * same as above for a script that is already in memory, such as a mapped
+    * file. Each line is lexed where it lies, nothing is copied.
+    *
+    * @param begin : first character of the script
+    * @param end : one past the last character of the script
+    * @param out : stream the solutions are written to, one per line
+    */
+   void calculateBatch(const char *begin, const char *end, ostream &out);
+
    /**
     * @brief displayInputAndOutput
     * this function takes in two vectors of strings that hold the input and
@@ -79,43 +123,22 @@ public:
     */
    vector<Token> convertPostfix(const vector<Token> &infix);
 
-   /**
-    * @brief isAssignment
-    *
-    * @param postfix : takes in an infix vector
-    * @return true : if the vector is an assignment
-    * @return false : if it is not an assignment
-    */
-   bool isAnAssignment(vector<Token> &infix) const;
-
    /**
     * @brief assignVariable
-    * this function takes in the map of variables and the postfix expression
-    * and assigns the AST created from the postfix expression to the variable
-    *
-    * @param v : string variable
-    * @param variables : map of variables
-    * @param postfix : postfix vector
-    */
-   void assignVariable(string v,
-                       vector<Token> &postfix);
-
-   /**
-    * @brief assignVariableHelper
-    * this function creates a new infix vector without variable and assignment
-    * operator and then converts the infix vector to postfix. It then calls
-    * assignVariable
+    * this function stores the tree of an expression in a variable. The
+    * values kept for the variables that depend on the variable are dropped,
+    * the others are kept.
     *
-    * @param infix
-    * @param variables
-    * @return vector<Token>
+    * @param id : interned id of the variable
+    * @param ast : tree of the expression assigned to the variable
     */
-   vector<Token> assignVariableHelper(vector<Token> &infix);
+   void assignVariable(uint32_t id, const AST &ast);
 
    /**
     * @brief isValid
     * this functions checks to ensure that the infix vector of tokens is a valid
-    * expression by calling various functions
+    * expression in one pass, reporting every error of the line with its
+    * column
     *
     * @param infix : infix vector of tokens
     * @return true : if expression is valid
@@ -127,17 +150,62 @@ private:
    // stream of tokens
    TokenStream tstream;
 
-   // map of variables that hold an AST
-   map<string, AST> variables;
+   // tree assigned to each variable, indexed by interned id
+   SymbolTable variables;
+
+   // how the trees of the expressions are stored
+   StorageMode mode_;
+
+   // reads, checks and builds the tree of each line in one pass
+   Parser parser_;
+
+   // how many parentheses the solutions are printed with
+   PrintMode print_;
+
+   // solution of the line of a script being solved, printed into the same
+   // memory for every line
+   string solution_;
+
+   // arena shared by the temporary trees built while calculating one
+   // expression, it is reset before the next expression is read
+   shared_ptr<Arena> scratch_;
+
+   // code of the line being solved, compiled again for every line so its
+   // memory is reused
+   Bytecode bytecode_;
+
+   /**
+    * @brief solve
+    * this function solves the tree of a valid line in the storage mode of
+    * the calculator and appends the solution in infix form to a string. If
+    * the line is an assignment the tree is stored in its variable first.
+    *
+    * @param ast : tree of the line
+    * @param arena : arena for the trees of this line
+    * @param solution : string the simplified expression is appended to
+    */
+   void solve(AST &ast, const shared_ptr<Arena> &arena, string &solution);
 
    /**
-    * @brief initializeVariables
-    * this functions initializes the map of variables to an AST that is just
-    * a token with a type of variable and value that is a character from the
-    * alphabet
+    * @brief calculateScriptLine
+    * this function solves one line of a script and writes its solution
     *
+    * @param begin : first character of the line
+    * @param end : one past the last character of the line
+    * @param out : stream the solution is written to
+    * @return true : if the script goes on
+    * @return false : if the line is a .
     */
-   void initializeVariables();
+   bool calculateScriptLine(const char *begin, const char *end, ostream &out);
+
+   /**
+    * @brief nextScratchArena
+    * this function returns the arena for the trees of the next expression.
+    * The arena is reset and reused if no tree still refers to it.
+    *
+    * @return shared_ptr<Arena> : arena for the next expression
+    */
+   shared_ptr<Arena> nextScratchArena();
 
    /**
     * @brief precedence
@@ -147,7 +215,7 @@ private:
     * @param t : token
     * @return int : precedence rank
     */
-   int precedence(Token t) const;
+   int precedence(const Token &t) const;
 
    /**
     * @brief isLeftParen
@@ -156,7 +224,7 @@ private:
     * @return true : if is a left parenthesis
     * @return false : if not
     */
-   bool isLeftParen(Token t) const;
+   bool isLeftParen(const Token &t) const;
 
    /**
     * @brief isRightParen
@@ -165,7 +233,7 @@ private:
     * @return true : if is a right parenthesis
     * @return false : false if not
     */
-   bool isRightParen(Token t) const;
+   bool isRightParen(const Token &t) const;
 
    /**
     * @brief hasPrecedence
@@ -176,7 +244,7 @@ private:
     * @return true : returns true if first token has precedence
     * @return false : false if not
     */
-   bool hasPrecedence(Token tok1, Token tok2) const;
+   bool hasPrecedence(const Token &tok1, const Token &tok2) const;
 
    /**
     * @brief isRightAssoc
@@ -185,115 +253,5 @@ private:
     * @param t : token
     * @return int : returns true if right associative (^)
     */
-   bool isRightAssoc(Token t) const;
-
-   /**
-    * @brief isValidToken
-    *
-    * @param infix
-    * @return true : if is a valid token
-    * @return false : if not
-    */
-   bool isValidToken(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidFirstToken
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the first token is a valid type
-    * @return false : if not valid
-    */
-   bool isValidFirstToken(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidLastToken
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the last token is a valid type
-    * @return false : if not
-    */
-   bool isValidLastToken(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidSize
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the size of the vector is less than 80 tokens
-    * @return false : if it is larger than 80 tokens
-    */
-   bool isValidSize(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidBinop
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the token after binop is allowed
-    * @return false : if it is not allowed
-    */
-   bool isValidBinop(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidVariable
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the token after variable is allowed
-    * @return false : if it is not allowed
-    */
-   bool isValidVariable(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidNumber
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if token after number is allowed
-    * @return false : if it is not allowed
-    */
-   bool isValidNumber(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidPowop
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the token after the power operator is valid
-    * @return false : if it is not valid
-    */
-   bool isValidPowop(vector<Token> &infix) const;
-
-   bool isValidPowHelper(vector<Token> &infix, int lparen) const;
-
-   /**
-    * @brief isValidAssignop
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the token after assignop is allowed
-    * @return false : if it is not allowed
-    */
-   bool isValidAssignop(vector<Token> &infix) const;
-
-   /**
-    * @brief isValidEol
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the eol is at the end of the expression
-    * @return false : if it is not at end of expression
-    */
-   bool isValidEol(vector<Token> &infix) const;
-
-   /**
-    * @brief
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the token after the rparen is valid
-    * @return false if it is not allowed
-    */
-   bool isValidRParen(vector<Token> &infix) const;
-
-   /**
-    * @brief
-    *
-    * @param infix : infix vector of tokens
-    * @return true : if the token after lparen is valid
-    * @return false : if it is not allowed
-    */
-   bool isValidLParen(vector<Token> &infix) const;
+   bool isRightAssoc(const Token &t) const;
 };
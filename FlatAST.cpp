@@ -0,0 +1,349 @@
+/**
+ * @file FlatAST.cpp
+ * @author Katarina McGaughy
+ * @brief The FlatAST class is an alternative storage for an AST. Instead of
+ * nodes linked by pointers, the nodes live in one vector in postfix order and
+ * refer to their children by 32 bit index. Every child comes before its
+ * parent, so flattening and printing are linear sweeps over the vector. A
+ * tree is simplified by the rules of AST, so a line has the same solution
+ * in either storage.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "FlatAST.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include <algorithm>
+#include <stack>
+#include <string>
+#include <utility>
+using namespace std;
+
+/**
+ * @brief Construct a new FlatAST object
+ * this constructor takes in a postfix vector of tokens and stores the
+ * nodes in the same order
+ * PRE: every number fits in its token, see AST::AST
+ *
+ * @param postfix : vector of tokens in postfix form
+ */
+FlatAST::FlatAST(const vector<Token> &postfix)
+{
+   nodes_.reserve(postfix.size());
+   for (int i = 0; i < postfix.size(); i++)
+   {
+      FlatNode node;
+      if (fromToken(postfix[i], node))
+      {
+         push(node);
+      }
+   }
+   operands_.clear();
+}
+
+/**
+ * @brief Construct a new FlatAST object
+ * this constructor flattens a pointer based AST
+ *
+ * @param ast : AST to flatten
+ */
+FlatAST::FlatAST(const AST &ast)
+{
+   if (ast.root_ == nullptr)
+   {
+      return;
+   }
+
+   // post order walk, the left operand comes out first
+   stack<pair<const AST::Node *, bool> > walk;
+   walk.push(make_pair(ast.root_, false));
+   while (!walk.empty())
+   {
+      const AST::Node *node = walk.top().first;
+      bool visited = walk.top().second;
+      walk.pop();
+      if (visited || node->left == nullptr)
+      {
+         FlatNode flat;
+         if (fromToken(node->token, flat))
+         {
+            // a value that does not fit lives in the arena of the tree
+            if (node->big != nullptr)
+            {
+               flat.big = true;
+               flat.value = numbers_.size();
+               numbers_.push_back(*node->big);
+            }
+            push(flat);
+         }
+      }
+      else
+      {
+         walk.push(make_pair(node, true));
+         walk.push(make_pair(node->right, false));
+         walk.push(make_pair(node->left, false));
+      }
+   }
+   operands_.clear();
+}
+
+/**
+ * @brief fromToken
+ * this function converts a token into a node without children
+ *
+ * @param t : token
+ * @param node : node that is filled in
+ * @return true : if the token is part of a tree
+ * @return false : if the token is not (parentheses, eol, ...)
+ */
+bool FlatAST::fromToken(const Token &t, FlatNode &node)
+{
+   node.type = t.type_;
+   node.op = t.op_;
+   node.big = false;
+   node.value = 0;
+   if (t.type_ == number)
+   {
+      node.value = t.number_;
+      return true;
+   }
+   if (t.type_ == variable)
+   {
+      node.id = t.id_;
+   }
+   return t.type_ == variable || t.type_ == binop || t.type_ == powop;
+}
+
+/**
+ * @brief numberText
+ *
+ * @param node : number node
+ * @return string : the number as it is printed, without parentheses
+ */
+string FlatAST::numberText(const FlatNode &node) const
+{
+   if (!node.big)
+   {
+      return to_string(node.value);
+   }
+   return numbers_[node.value].toString();
+}
+
+/**
+ * @brief parenthesized
+ * this function decides if a node is printed in parentheses, see
+ * AST::parenthesized
+ *
+ * @param node : the operand
+ * @param print : how many parentheses are printed
+ * @param parent : operation the operand belongs to, opNone for the root
+ * @param right : true if it is the right operand
+ * @return true : if the node is printed in parentheses
+ * @return false : if not
+ */
+bool FlatAST::parenthesized(const FlatNode &node, PrintMode print,
+                            Opcode parent, bool right) const
+{
+   if (node.type == binop || node.type == powop)
+   {
+      return AST::parenthesized(print, parent, node.op, false, right);
+   }
+   if (node.type != number)
+   {
+      return AST::parenthesized(print, parent, opNone, false, right);
+   }
+   if (!node.big)
+   {
+      return AST::parenthesized(print, parent, opNone, node.value < 0, right);
+   }
+   // a fraction is printed like a division
+   const Rational &value = numbers_[node.value];
+   return AST::parenthesized(print, parent,
+                             value.isInteger() ? opNone : opDiv,
+                             value.isNegative(), right);
+}
+
+/**
+ * @brief push
+ * this function appends a node in postfix order. An operator takes the
+ * last two subtrees as its operands.
+ *
+ * @param node : node to append
+ */
+void FlatAST::push(FlatNode node)
+{
+   if (node.type == binop || node.type == powop)
+   {
+      uint32_t right = operands_.back();
+      operands_.pop_back();
+      uint32_t left = operands_.back();
+      operands_.pop_back();
+      node.child[0] = left;
+      node.child[1] = right;
+   }
+   operands_.push_back(nodes_.size());
+   nodes_.push_back(node);
+}
+
+/**
+ * @brief toTree
+ * this method builds the pointer based AST of the tree
+ *
+ * @return AST : the tree with nodes linked by pointers
+ */
+AST FlatAST::toTree() const
+{
+   AST tree = AST(make_shared<Arena>());
+   // children come before their parent, so their nodes are made first
+   vector<AST::Node *> made(nodes_.size());
+   for (int i = 0; i < nodes_.size(); i++)
+   {
+      const FlatNode &node = nodes_[i];
+      if (node.type == number)
+      {
+         made[i] = node.big ? tree.makeBigNumber(numbers_[node.value])
+                            : tree.makeNode(Token::fromNumber(node.value));
+      }
+      else if (node.type == variable)
+      {
+         made[i] = tree.makeNode(Token::fromVariable(node.id));
+      }
+      else
+      {
+         made[i] = tree.makeNode(Token(node.type, node.op),
+                                 made[node.child[0]], made[node.child[1]]);
+      }
+   }
+   tree.root_ = made.back();
+   return tree;
+}
+
+/**
+ * @brief simplify
+ * this method simplifies the tree the way AST::simplifyTree does, with
+ * every variable replaced by its stored AST, every calculation done that
+ * can be done exactly and the rules of AST applied. The tree is built
+ * again with pointers, simplified and flattened, so the values kept for
+ * the stored trees are used as well.
+ *
+ * @param variables : table of the trees assigned to the variables
+ * @return FlatAST : the simplified tree
+ */
+FlatAST FlatAST::simplify(SymbolTable &variables) const
+{
+   if (nodes_.empty())
+   {
+      return FlatAST();
+   }
+   return FlatAST(toTree().simplifyTree(variables));
+}
+
+/**
+ * @brief toInfix
+ * this method prints the tree in infix form with every operator in
+ * parentheses
+ *
+ * @return string : infix form of expression
+ */
+string FlatAST::toInfix() const
+{
+   string infix;
+   toInfix(infix, fullParentheses);
+   return infix;
+}
+
+/**
+ * @brief toInfix
+ * this method appends the infix form of the tree to a string. One sweep
+ * decides which subtrees are in parentheses, one measures every subtree,
+ * one places every subtree in the output and one writes the characters,
+ * so the string grows once and every character is written once.
+ *
+ * @param infix : string the expression is appended to
+ * @param print : how many parentheses are printed
+ */
+void FlatAST::toInfix(string &infix, PrintMode print) const
+{
+   if (nodes_.empty())
+   {
+      return;
+   }
+   int root = nodes_.size() - 1;
+
+   // 1 if a subtree is printed in parentheses, parents come last
+   vector<uint8_t> wrapped(nodes_.size());
+   wrapped[root] = parenthesized(nodes_[root], print, opNone, false);
+   for (int i = root; i >= 0; i--)
+   {
+      const FlatNode &node = nodes_[i];
+      if (node.type == binop || node.type == powop)
+      {
+         wrapped[node.child[0]] =
+             parenthesized(nodes_[node.child[0]], print, node.op, false);
+         wrapped[node.child[1]] =
+             parenthesized(nodes_[node.child[1]], print, node.op, true);
+      }
+   }
+
+   // length of the printed form of every subtree, children come first
+   vector<uint32_t> length(nodes_.size());
+   for (int i = 0; i < nodes_.size(); i++)
+   {
+      const FlatNode &node = nodes_[i];
+      if (node.type == number)
+      {
+         length[i] = numberText(node).size();
+      }
+      else if (node.type == variable)
+      {
+         length[i] = Symbols::name(node.id).size();
+      }
+      else
+      {
+         length[i] = length[node.child[0]] + length[node.child[1]] + 1;
+      }
+      length[i] += 2 * wrapped[i];
+   }
+
+   // where every subtree starts in the output, parents come last
+   vector<uint32_t> offset(nodes_.size());
+   offset[root] = infix.size();
+   for (int i = root; i >= 0; i--)
+   {
+      const FlatNode &node = nodes_[i];
+      if (node.type == binop || node.type == powop)
+      {
+         offset[node.child[0]] = offset[i] + wrapped[i];
+         offset[node.child[1]] =
+             offset[node.child[0]] + length[node.child[0]] + 1;
+      }
+   }
+
+   infix.resize(infix.size() + length[root], ' ');
+   for (int i = 0; i < nodes_.size(); i++)
+   {
+      const FlatNode &node = nodes_[i];
+      if (wrapped[i])
+      {
+         infix[offset[i]] = '(';
+         infix[offset[i] + length[i] - 1] = ')';
+      }
+      if (node.type == number)
+      {
+         string digits = numberText(node);
+         infix.replace(offset[i] + wrapped[i], digits.size(), digits);
+      }
+      else if (node.type == variable)
+      {
+         const string &name = Symbols::name(node.id);
+         infix.replace(offset[i] + wrapped[i], name.size(), name);
+      }
+      else
+      {
+         infix[offset[node.child[1]] - 1] = opcodeSymbol(node.op);
+      }
+   }
+}
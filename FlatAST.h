@@ -0,0 +1,187 @@
+/**
+ * @file FlatAST.h
+ * @author Katarina McGaughy
+ * @brief The FlatAST class is an alternative storage for an AST. Instead of
+ * nodes linked by pointers, the nodes live in one vector in postfix order and
+ * refer to their children by 32 bit index. Every child comes before its
+ * parent, so flattening and printing are linear sweeps over the vector. A
+ * tree is simplified by the rules of AST, so a line has the same solution
+ * in either storage.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Token.h"
+#include "AST.h"
+#pragma once
+
+class SymbolTable;
+
+class FlatAST
+{
+
+private:
+  /**
+   * @brief FlatNode
+   * a node of the flat tree. Operators store the index of their left and
+   * right operand, numbers store their value and variables their interned
+   * id. A number that does not fit or is a fraction stores the index of its
+   * value in numbers_.
+   * The whole node is 16 bytes.
+   */
+  struct FlatNode
+  {
+    // number, variable, binop or powop
+    TokenType type;
+
+    // operation of a binop or powop
+    Opcode op;
+
+    // true if value is the index of the value in numbers_
+    bool big;
+
+    union
+    {
+      // index of the left and right operand of an operator
+      uint32_t child[2];
+
+      // value of a number
+      int64_t value;
+
+      // interned id of a variable
+      uint32_t id;
+    };
+  };
+
+  // nodes in postfix order, the root is the last node
+  vector<FlatNode> nodes_;
+
+  // indexes of the subtrees that do not have a parent yet while building
+  vector<uint32_t> operands_;
+
+  // values of the numbers that do not fit in a node, they belong to the
+  // tree and are freed with it
+  vector<Rational> numbers_;
+
+  /**
+   * @brief push
+   * this function appends a node in postfix order. An operator takes the
+   * last two subtrees as its operands.
+   *
+   * @param node : node to append
+   */
+  void push(FlatNode node);
+
+  /**
+   * @brief fromToken
+   * this function converts a token into a node without children
+   *
+   * @param t : token
+   * @param node : node that is filled in
+   * @return true : if the token is part of a tree
+   * @return false : if the token is not (parentheses, eol, ...)
+   */
+  static bool fromToken(const Token &t, FlatNode &node);
+
+  /**
+   * @brief toTree
+   * this method builds the pointer based AST of the tree
+   *
+   * @return AST : the tree with nodes linked by pointers
+   */
+  AST toTree() const;
+
+  /**
+   * @brief numberText
+   *
+   * @param node : number node
+   * @return string : the number as it is printed, without parentheses
+   */
+  string numberText(const FlatNode &node) const;
+
+  /**
+   * @brief parenthesized
+   * this function decides if a node is printed in parentheses, see
+   * AST::parenthesized
+   *
+   * @param node : the operand
+   * @param print : how many parentheses are printed
+   * @param parent : operation the operand belongs to, opNone for the root
+   * @param right : true if it is the right operand
+   * @return true : if the node is printed in parentheses
+   * @return false : if not
+   */
+  bool parenthesized(const FlatNode &node, PrintMode print, Opcode parent,
+                     bool right) const;
+
+public:
+  /**
+   * @brief Construct a new FlatAST object
+   * default constructor, creates an empty tree
+   */
+  FlatAST() {}
+
+  /**
+   * @brief Construct a new FlatAST object
+   * this constructor takes in a postfix vector of tokens and stores the
+   * nodes in the same order
+   * PRE: every number fits in its token, see AST::AST
+   *
+   * @param postfix : vector of tokens in postfix form
+   */
+  FlatAST(const vector<Token> &postfix);
+
+  /**
+   * @brief Construct a new FlatAST object
+   * this constructor flattens a pointer based AST
+   *
+   * @param ast : AST to flatten
+   */
+  FlatAST(const AST &ast);
+
+  /**
+   * @brief simplify
+   * this method simplifies the tree the way AST::simplifyTree does, with
+   * every variable replaced by its stored AST, every calculation done that
+   * can be done exactly and the rules of AST applied. The tree is built
+   * again with pointers, simplified and flattened, so the values kept for
+   * the stored trees are used as well.
+   *
+   * @param variables : table of the trees assigned to the variables
+   * @return FlatAST : the simplified tree
+   */
+  FlatAST simplify(SymbolTable &variables) const;
+
+  /**
+   * @brief toInfix
+   * this method prints the tree in infix form with every operator in
+   * parentheses
+   *
+   * @return string : infix form of expression
+   */
+  string toInfix() const;
+
+  /**
+   * @brief toInfix
+   * this method appends the infix form of the tree to a string. One sweep
+   * decides which subtrees are in parentheses, one measures every subtree,
+   * one places every subtree in the output and one writes the characters,
+   * so the string grows once and every character is written once.
+   *
+   * @param infix : string the expression is appended to
+   * @param print : how many parentheses are printed
+   */
+  void toInfix(string &infix, PrintMode print = fullParentheses) const;
+
+  /**
+   * @brief size
+   *
+   * @return size_t : number of nodes in the tree
+   */
+  size_t size() const { return nodes_.size(); }
+};
@@ -0,0 +1,97 @@
+/**
+ * @file LineReader.cpp
+ * @author Katarina McGaughy
+ * @brief The LineReader class splits an input stream into lines, reading the
+ * stream in large blocks.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "LineReader.h"
+#include <cstring>
+using namespace std;
+
+/**
+ * @brief Construct a new LineReader object
+ *
+ * @param inputStream : stream to read
+ * @param bufferSize : size in bytes of each read
+ */
+LineReader::LineReader(istream &inputStream, size_t bufferSize)
+    : is_(inputStream), buffer_(bufferSize), begin_(0), end_(0), eof_(false)
+{
+}
+
+/**
+ * @brief refill
+ * this function moves the unread bytes to the front of the buffer and
+ * reads the next block of the stream after them
+ */
+void LineReader::refill()
+{
+   size_t unread = end_ - begin_;
+   if (begin_ > 0)
+   {
+      memmove(buffer_.data(), buffer_.data() + begin_, unread);
+      begin_ = 0;
+      end_ = unread;
+   }
+   if (end_ == buffer_.size())
+   {
+      // the line does not fit, make room for it
+      buffer_.resize(buffer_.size() * 2);
+   }
+   is_.read(buffer_.data() + end_, buffer_.size() - end_);
+   end_ += is_.gcount();
+   if (!is_)
+   {
+      eof_ = true;
+   }
+}
+
+/**
+ * @brief next
+ * this function finds the next line. The range includes the '\n' that
+ * ends the line, one is added to a last line that does not have it. The
+ * range is valid until next() is called again.
+ *
+ * @param begin : first character of the line
+ * @param end : one past the '\n' of the line
+ * @return true : if there was a line
+ * @return false : at the end of the stream
+ */
+bool LineReader::next(const char *&begin, const char *&end)
+{
+   // bytes before scanned are known not to be '\n'
+   size_t scanned = begin_;
+   while (true)
+   {
+      const char *data = buffer_.data();
+      const char *newline = static_cast<const char *>(
+          memchr(data + scanned, '\n', end_ - scanned));
+      if (newline != nullptr)
+      {
+         begin = data + begin_;
+         end = newline + 1;
+         begin_ = end - data;
+         return true;
+      }
+      if (eof_)
+      {
+         if (begin_ == end_)
+         {
+            return false;
+         }
+         if (end_ == buffer_.size())
+         {
+            buffer_.resize(buffer_.size() + 1);
+         }
+         buffer_[end_++] = '\n';
+         continue;
+      }
+      scanned = end_ - begin_;
+      refill();
+   }
+}
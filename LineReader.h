@@ -0,0 +1,67 @@
+/**
+ * @file LineReader.h
+ * @author Katarina McGaughy
+ * @brief The LineReader class splits an input stream into lines. It reads
+ * the stream in large blocks into one buffer and hands out each line as a
+ * range of that buffer, so a script of any length is read in constant
+ * memory and without a call per character.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstddef>
+#include <istream>
+#include <vector>
+#pragma once
+using namespace std;
+
+class LineReader
+{
+
+private:
+   // stream the lines are read from
+   istream &is_;
+
+   // block of the stream, grows only for a line longer than the buffer
+   vector<char> buffer_;
+
+   // start of the next line in buffer_
+   size_t begin_;
+
+   // end of the bytes read into buffer_
+   size_t end_;
+
+   // true once the stream has no more bytes
+   bool eof_;
+
+   /**
+    * @brief refill
+    * this function moves the unread bytes to the front of the buffer and
+    * reads the next block of the stream after them
+    */
+   void refill();
+
+public:
+   /**
+    * @brief Construct a new LineReader object
+    *
+    * @param inputStream : stream to read
+    * @param bufferSize : size in bytes of each read
+    */
+   explicit LineReader(istream &inputStream, size_t bufferSize = 1 << 20);
+
+   /**
+    * @brief next
+    * this function finds the next line. The range includes the '\n' that
+    * ends the line, one is added to a last line that does not have it. The
+    * range is valid until next() is called again.
+    *
+    * @param begin : first character of the line
+    * @param end : one past the '\n' of the line
+    * @return true : if there was a line
+    * @return false : at the end of the stream
+    */
+   bool next(const char *&begin, const char *&end);
+};
@@ -0,0 +1,79 @@
+/**
+ * @file MappedFile.cpp
+ * @author Katarina McGaughy
+ * @brief The MappedFile class maps a file into memory read only.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+/**
+ * @brief Destroy the MappedFile object
+ * unmaps the file
+ */
+MappedFile::~MappedFile()
+{
+   if (data_ != nullptr && size_ > 0)
+   {
+      munmap(const_cast<char *>(data_), size_);
+   }
+}
+
+/**
+ * @brief open
+ * this function maps a regular file and tells the kernel it will be read
+ * from front to back. An empty file is opened without being mapped.
+ *
+ * @param path : file to map
+ * @return true : if the file is mapped
+ * @return false : if it could not be opened or is not a regular file,
+ * such as a pipe, it has to be read as a stream instead
+ */
+bool MappedFile::open(const char *path)
+{
+   int fd = ::open(path, O_RDONLY);
+   if (fd < 0)
+   {
+      return false;
+   }
+   struct stat info;
+   if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+   {
+      close(fd);
+      return false;
+   }
+
+   static const char empty = '\0';
+   size_t size = info.st_size;
+   const char *data = &empty;
+   if (size > 0)
+   {
+      void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED)
+      {
+         close(fd);
+         return false;
+      }
+      // read ahead aggressively and drop pages behind the reader
+      madvise(mapping, size, MADV_SEQUENTIAL);
+      data = static_cast<const char *>(mapping);
+   }
+   // the mapping stays valid after the descriptor is closed
+   close(fd);
+
+   if (data_ != nullptr && size_ > 0)
+   {
+      munmap(const_cast<char *>(data_), size_);
+   }
+   data_ = data;
+   size_ = size;
+   return true;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file MappedFile.h
+ * @author Katarina McGaughy
+ * @brief The MappedFile class maps a file into memory read only, so a script
+ * can be lexed straight from the pages of the file without being read
+ * through a stream buffer or copied.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstddef>
+#pragma once
+using namespace std;
+
+class MappedFile
+{
+
+private:
+   // first byte of the mapping, nullptr if nothing is mapped
+   const char *data_;
+
+   // number of bytes in the file
+   size_t size_;
+
+public:
+   /**
+    * @brief Construct a new MappedFile object
+    * nothing is mapped until open() is called
+    */
+   MappedFile() : data_(nullptr), size_(0) {}
+
+   /**
+    * @brief Destroy the MappedFile object
+    * unmaps the file
+    */
+   ~MappedFile();
+
+   MappedFile(const MappedFile &) = delete;
+   MappedFile &operator=(const MappedFile &) = delete;
+
+   /**
+    * @brief open
+    * this function maps a regular file and tells the kernel it will be read
+    * from front to back. An empty file is opened without being mapped.
+    *
+    * @param path : file to map
+    * @return true : if the file is mapped
+    * @return false : if it could not be opened or is not a regular file,
+    * such as a pipe, it has to be read as a stream instead
+    */
+   bool open(const char *path);
+
+   /**
+    * @brief begin
+    *
+    * @return const char* : first byte of the file
+    */
+   const char *begin() const { return data_; }
+
+   /**
+    * @brief end
+    *
+    * @return const char* : one past the last byte of the file
+    */
+   const char *end() const { return data_ + size_; }
+
+   /**
+    * @brief size
+    *
+    * @return size_t : number of bytes in the file
+    */
+   size_t size() const { return size_; }
+};
@@ -0,0 +1,438 @@
+/**
+ * @file Parser.cpp
+ * @author Katarina McGaughy
+ * @brief The Parser class turns a line of tokens into an AST in one pass,
+ * validating and running the shunting-yard algorithm as the tokens are read.
+ * The tokens of a line are lexed into a vector that is reused for every
+ * line.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Parser.h"
+#include <iostream>
+using namespace std;
+
+// binding power of each opcode on its left and on its right. An operator
+// whose right power is higher than its left is left associative, ^ is
+// right associative.
+static const unsigned char leftPower[] = {0, 10, 10, 20, 20, 31};
+static const unsigned char rightPower[] = {0, 11, 11, 21, 21, 30};
+
+// binding power of a unary minus, -2^2 is -(2^2) and -2*3 is (-2)*3
+static const unsigned char negatePower = 25;
+
+/**
+ * @brief Construct a new Parser object
+ *
+ * @param mode : how lines are parsed
+ */
+Parser::Parser(ParseMode mode) : mode_(mode), ending_(false),
+                                 assignment_(false), target_(0),
+                                 tokens_(nullptr), ast_(nullptr),
+                                 text_(nullptr), valid_(true), at_(0)
+{
+}
+
+/**
+ * @brief popsBefore
+ *
+ * @param top : operator on top of the stack
+ * @param next : operator that was read
+ * @return true : if top has to be built before next is pushed
+ * @return false : if next binds tighter or is right associative
+ */
+bool Parser::popsBefore(const Token &top, const Token &next)
+{
+   return rightPower[top.op_] > leftPower[next.op_];
+}
+
+/**
+ * @brief reduce
+ * this function pops the top operator and builds its node from the two
+ * operands on top of the operand stack
+ *
+ * @param ast : tree the node is built in
+ */
+void Parser::reduce(AST &ast)
+{
+   AST::Node *right = operands_.back();
+   operands_.pop_back();
+   AST::Node *left = operands_.back();
+   operands_.back() = ast.makeNode(operators_.back(), left, right);
+   operators_.pop_back();
+}
+
+/**
+ * @brief parse
+ * this function reads the tokens of one line and builds the tree of its
+ * expression. Both ways report every error of the line.
+ *
+ * @param tokens : stream the line is read from
+ * @param ast : empty tree that receives the expression
+ * @param text : if not null, the text of the tokens is appended to it
+ * @return true : if the line is a valid expression or assignment
+ * @return false : if it has an error, is empty or is a .
+ */
+bool Parser::parse(TokenStream &tokens, AST &ast, string *text)
+{
+   // the stream finds the tokens of a whole line a block of characters at a
+   // time, which is faster than asking it for one token after another
+   line_.clear();
+   tokens >> line_;
+   if (mode_ == precedenceClimbing)
+   {
+      return parseClimbing(tokens, ast, text);
+   }
+   return parseStack(tokens, ast, text);
+}
+
+/**
+ * @brief parseStack
+ * this function parses a line with the shunting-yard algorithm. Every
+ * error of the line is reported, and the line is read to its end even
+ * after an error.
+ *
+ * @param tokens : stream the line was read from, it holds the values
+ * of its big numbers
+ * @param ast : empty tree that receives the expression
+ * @param text : if not null, the text of the tokens is appended to it
+ * @return true : if the line is a valid expression or assignment
+ * @return false : if it has an error, is empty or is a .
+ */
+bool Parser::parseStack(TokenStream &tokens, AST &ast, string *text)
+{
+   validator_.reset();
+   operands_.clear();
+   operators_.clear();
+   ending_ = false;
+   assignment_ = false;
+
+   if (line_[0].type_ == ending)
+   {
+      ending_ = true;
+      return false;
+   }
+
+   // the last token of the line is its eol
+   for (size_t i = 0; i < line_.size(); i++)
+   {
+      const Token &tok = line_[i];
+      if (text != nullptr)
+      {
+         *text += tokens.text(tok);
+      }
+      // once the line has an error only the checking goes on
+      if (validator_.accept(tok))
+      {
+         switch (tok.type_)
+         {
+         case number:
+         case variable:
+            // the value of a big number is copied out of the stream
+            operands_.push_back(tok.big_ ? ast.makeBigNumber(
+                                               tokens.bigNumber(tok))
+                                         : ast.makeNode(tok));
+            break;
+         case assignop:
+            // the variable before it is the target, not an operand
+            assignment_ = true;
+            target_ = operands_.back()->token.id_;
+            operands_.pop_back();
+            break;
+         case binop:
+         case powop:
+            while (!operators_.empty() && operators_.back().type_ != lparen &&
+                   popsBefore(operators_.back(), tok))
+            {
+               reduce(ast);
+            }
+            operators_.push_back(tok);
+            break;
+         case lparen:
+            operators_.push_back(tok);
+            break;
+         case rparen:
+            while (operators_.back().type_ != lparen)
+            {
+               reduce(ast);
+            }
+            operators_.pop_back();
+            break;
+         default:
+            break;
+         }
+      }
+   }
+
+   if (!validator_.finish())
+   {
+      return false;
+   }
+   while (!operators_.empty())
+   {
+      reduce(ast);
+   }
+   ast.root_ = operands_.back();
+   return true;
+}
+
+/**
+ * @brief parseClimbing
+ * this function parses a line by precedence climbing. Each operator is read
+ * by the loop of the operand on its left for as long as it binds tighter
+ * than the operator before that operand, so no operator is ever pushed or
+ * popped.
+ *
+ * @param tokens : stream the line was read from, it holds the values
+ * of its big numbers
+ * @param ast : empty tree that receives the expression
+ * @param text : if not null, the text of the tokens is appended to it
+ * @return true : if the line is a valid expression or assignment
+ * @return false : if it has an error, is empty or is a .
+ */
+bool Parser::parseClimbing(TokenStream &tokens, AST &ast, string *text)
+{
+   tokens_ = &tokens;
+   ast_ = &ast;
+   text_ = text;
+   valid_ = true;
+   ending_ = false;
+   assignment_ = false;
+   at_ = 0;
+
+   advance();
+   if (next_.type_ == ending)
+   {
+      ending_ = true;
+      return false;
+   }
+   // an empty line is skipped without an error
+   if (next_.type_ == eol)
+   {
+      return false;
+   }
+   // a line that starts with a variable is an assignment if := follows
+   AST::Node *first = nullptr;
+   if (next_.type_ == variable)
+   {
+      Token name = next_;
+      advance();
+      if (next_.type_ == assignop)
+      {
+         assignment_ = true;
+         target_ = name.id_;
+         advance();
+      }
+      else if (next_.type_ == lparen)
+      {
+         // the parentheses are read as if the name were not there
+         fail("Function calls are not supported", next_);
+      }
+      else
+      {
+         first = ast.makeNode(name);
+      }
+   }
+   ast.root_ = climb(first);
+   return valid_;
+}
+
+/**
+ * @brief advance
+ * this function moves next_ to the token after it
+ * PRE: next_ is not the eol of the line
+ */
+void Parser::advance()
+{
+   next_ = line_[at_++];
+   if (text_ != nullptr)
+   {
+      *text_ += tokens_->text(next_);
+   }
+}
+
+/**
+ * @brief fail
+ * this function reports an error of the line that is being climbed and
+ * marks the line invalid
+ *
+ * @param message : what is wrong
+ * @param token : the token that is wrong
+ */
+void Parser::fail(const char *message, const Token &token)
+{
+   cout << message << " at column " << token.offset_ + 1 << "." << endl;
+   valid_ = false;
+}
+
+/**
+ * @brief skip
+ * this function reports next_, which cannot follow the operand before it,
+ * and reads the token after it. If an operand starts there, it is read in
+ * place of the operand before, so it is not reported as well.
+ *
+ * @param node : the operand before next_
+ * @return AST::Node* : node, or nullptr if the next operand takes its place
+ */
+AST::Node *Parser::skip(AST::Node *node)
+{
+   if (next_.type_ == rparen)
+   {
+      fail("Unmatched right parenthesis", next_);
+   }
+   else if (next_.type_ == invalid)
+   {
+      fail("Invalid character entered", next_);
+   }
+   else
+   {
+      fail("Invalid character after expression", next_);
+   }
+   advance();
+   if (next_.type_ == number || next_.type_ == variable ||
+       next_.type_ == lparen)
+   {
+      return nullptr;
+   }
+   return node;
+}
+
+/**
+ * @brief climb
+ * this function reads an expression up to the end of the line. The open
+ * operators and parentheses are kept on pending_ instead of the call stack,
+ * so a line nested as deeply as it is long is read in time and memory
+ * linear in its length. A negated number is read as a negative number,
+ * anything else that is negated becomes 0 minus it. After an error the line
+ * is read on as if the wrong token were not there, or with a 0 for an
+ * operand that is missing, so every error of the line is reported.
+ *
+ * @param first : the first operand if it was already read, nullptr if not
+ * @return AST::Node* : tree of what was read
+ */
+AST::Node *Parser::climb(AST::Node *first)
+{
+   pending_.clear();
+   AST::Node *node = first;
+   // number of powers on pending_, a variable read while there is one is in
+   // an exponent
+   size_t exponents = 0;
+   while (true)
+   {
+      // read parentheses and unary minus up to the next number or variable
+      while (node == nullptr)
+      {
+         Token tok = next_;
+         switch (tok.type_)
+         {
+         case number:
+            // the value of a big number is copied out of the stream before
+            // it reads another line
+            node = tok.big_ ? ast_->makeBigNumber(tokens_->bigNumber(tok))
+                            : ast_->makeNode(tok);
+            advance();
+            break;
+         case variable:
+            advance();
+            if (next_.type_ == lparen)
+            {
+               // the tree has no node for a call, the parentheses are read
+               // as if the name were not there
+               fail("Function calls are not supported", next_);
+               break;
+            }
+            if (exponents != 0)
+            {
+               fail("Variable in exponent", tok);
+            }
+            node = ast_->makeNode(tok);
+            break;
+         case lparen:
+            advance();
+            pending_.push_back(Pending(tok, nullptr, 0));
+            break;
+         case binop:
+            advance();
+            if (tok.op_ != opSub)
+            {
+               fail("Invalid character before operand", tok);
+               break;
+            }
+            pending_.push_back(Pending(tok, nullptr, negatePower));
+            break;
+         case invalid:
+            fail("Invalid character entered", tok);
+            advance();
+            break;
+         default:
+            fail("Expected an operand", tok);
+            node = ast_->makeNode(Token::fromNumber(0));
+            break;
+         }
+      }
+
+      // an operator that binds tighter than the open one takes the operand
+      unsigned char minPower = pending_.empty() ? 0 : pending_.back().power;
+      if ((next_.type_ == binop || next_.type_ == powop) &&
+          leftPower[next_.op_] > minPower)
+      {
+         exponents += next_.type_ == powop;
+         pending_.push_back(Pending(next_, node, rightPower[next_.op_]));
+         advance();
+         node = nullptr;
+         continue;
+      }
+      if (pending_.empty())
+      {
+         if (next_.type_ == eol)
+         {
+            return node;
+         }
+         node = skip(node);
+         continue;
+      }
+
+      // otherwise the operand closes the open part on top
+      if (pending_.back().token.type_ == lparen)
+      {
+         if (next_.type_ == rparen)
+         {
+            advance();
+         }
+         else if (next_.type_ == eol)
+         {
+            fail("Unmatched left parenthesis", pending_.back().token);
+         }
+         else
+         {
+            // the parenthesis stays open for the tokens after next_
+            node = skip(node);
+            continue;
+         }
+         pending_.pop_back();
+         continue;
+      }
+      Pending open = pending_.back();
+      pending_.pop_back();
+      if (open.left == nullptr)
+      {
+         if (node->token.type_ == number && node->big == nullptr)
+         {
+            node->token.number_ = -node->token.number_;
+         }
+         else
+         {
+            node = ast_->makeNode(Token(binop, opSub),
+                                  ast_->makeNode(Token::fromNumber(0)), node);
+         }
+      }
+      else
+      {
+         exponents -= open.token.type_ == powop;
+         node = ast_->makeNode(open.token, open.left, node);
+      }
+   }
+}
@@ -0,0 +1,240 @@
+/**
+ * @file Parser.h
+ * @author Katarina McGaughy
+ * @brief The Parser class turns a line of tokens into an AST in one pass.
+ * It reads the tokens of a line from a TokenStream into a vector that is
+ * reused for every line and builds a node of the tree as soon as an
+ * operator has both operands, no infix or postfix vector is made per line. It parses in one of two ways: by the
+ * shunting-yard algorithm, checking each token with a Validator, or by
+ * precedence climbing, which also reads unary minus.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "Token.h"
+#include "TokenStream.h"
+#include "Validator.h"
+#pragma once
+using namespace std;
+
+/**
+ * @brief ParseMode
+ * Enum that selects how the parser reads a line, either with the
+ * shunting-yard algorithm and its stacks or by precedence climbing
+ */
+enum ParseMode
+{
+   shuntingYard,
+   precedenceClimbing
+};
+
+class Parser
+{
+
+private:
+   // how lines are parsed
+   ParseMode mode_;
+
+   // checks the tokens as they are read
+   Validator validator_;
+
+   // subtrees that are waiting for their operator
+   vector<AST::Node *> operands_;
+
+   // operators and left parentheses that are waiting for their right
+   // operand
+   vector<Token> operators_;
+
+   // true if the last line was a .
+   bool ending_;
+
+   // true if the last line was an assignment
+   bool assignment_;
+
+   // id of the variable the last line assigned to
+   uint32_t target_;
+
+   // stream and tree of the line that is being climbed
+   TokenStream *tokens_;
+   AST *ast_;
+
+   // next token of the line that is being climbed
+   Token next_;
+
+   // receives the text of the tokens, may be null
+   string *text_;
+
+   // false once the line that is being climbed has an error
+   bool valid_;
+
+   // tokens of the line that is being parsed, up to and including its eol
+   vector<Token> line_;
+
+   // position in line_ of the token after next_
+   size_t at_;
+
+   /**
+    * @brief Pending
+    * part of the line that is being climbed that is still open: a binary
+    * operator waiting for its right operand, a left parenthesis waiting for
+    * its right one or a unary minus waiting for its operand
+    */
+   struct Pending
+   {
+      // the operator or the parenthesis
+      Token token;
+
+      // left operand of a binary operator, nullptr for the others
+      AST::Node *left;
+
+      // operators after the operand bind to it if their left power is higher
+      unsigned char power;
+
+      Pending(const Token &tok, AST::Node *node, unsigned char minPower)
+          : token(tok), left(node), power(minPower)
+      {
+      }
+   };
+
+   // open parts of the line that is being climbed, kept from one line to the
+   // next
+   vector<Pending> pending_;
+
+   /**
+    * @brief popsBefore
+    *
+    * @param top : operator on top of the stack
+    * @param next : operator that was read
+    * @return true : if top has to be built before next is pushed
+    * @return false : if next binds tighter or is right associative
+    */
+   static bool popsBefore(const Token &top, const Token &next);
+
+   /**
+    * @brief reduce
+    * this function pops the top operator and builds its node from the two
+    * operands on top of the operand stack
+    *
+    * @param ast : tree the node is built in
+    */
+   void reduce(AST &ast);
+
+   /**
+    * @brief parseStack
+    * this function parses a line with the shunting-yard algorithm
+    *
+    * @param tokens : stream the line was read from, it holds the values
+    * of its big numbers
+    * @param ast : empty tree that receives the expression
+    * @param text : if not null, the text of the tokens is appended to it
+    * @return true : if the line is a valid expression or assignment
+    * @return false : if it has an error, is empty or is a .
+    */
+   bool parseStack(TokenStream &tokens, AST &ast, string *text);
+
+   /**
+    * @brief parseClimbing
+    * this function parses a line by precedence climbing
+    *
+    * @param tokens : stream the line was read from, it holds the values
+    * of its big numbers
+    * @param ast : empty tree that receives the expression
+    * @param text : if not null, the text of the tokens is appended to it
+    * @return true : if the line is a valid expression or assignment
+    * @return false : if it has an error, is empty or is a .
+    */
+   bool parseClimbing(TokenStream &tokens, AST &ast, string *text);
+
+   /**
+    * @brief advance
+    * this function moves next_ to the token after it
+    * PRE: next_ is not the eol of the line
+    */
+   void advance();
+
+   /**
+    * @brief fail
+    * this function reports an error of the line that is being climbed and
+    * marks the line invalid
+    *
+    * @param message : what is wrong
+    * @param token : the token that is wrong
+    */
+   void fail(const char *message, const Token &token);
+
+   /**
+    * @brief skip
+    * this function reports next_, which cannot follow the operand before it,
+    * and reads the token after it. If an operand starts there, it is read
+    * in place of the operand before, so it is not reported as well.
+    *
+    * @param node : the operand before next_
+    * @return AST::Node* : node, or nullptr if the next operand takes its
+    * place
+    */
+   AST::Node *skip(AST::Node *node);
+
+   /**
+    * @brief climb
+    * this function reads an expression up to the end of the line. The open
+    * operators and parentheses are kept on pending_ instead of the call
+    * stack, so a line nested as deeply as it is long is read in time and
+    * memory linear in its length. After an error the line is read on, so
+    * every error of the line is reported.
+    *
+    * @param first : the first operand if it was already read, nullptr if not
+    * @return AST::Node* : tree of what was read
+    */
+   AST::Node *climb(AST::Node *first);
+
+public:
+   /**
+    * @brief Construct a new Parser object
+    *
+    * @param mode : how lines are parsed
+    */
+   explicit Parser(ParseMode mode = shuntingYard);
+
+   /**
+    * @brief parse
+    * this function reads the tokens of one line and builds the tree of its
+    * expression. Both ways report every error of the line.
+    *
+    * @param tokens : stream the line is read from
+    * @param ast : empty tree that receives the expression
+    * @param text : if not null, the text of the tokens is appended to it
+    * @return true : if the line is a valid expression or assignment
+    * @return false : if it has an error, is empty or is a .
+    */
+   bool parse(TokenStream &tokens, AST &ast, string *text = nullptr);
+
+   /**
+    * @brief endOfInput
+    *
+    * @return true : if the last line was a .
+    * @return false : if not
+    */
+   bool endOfInput() const { return ending_; }
+
+   /**
+    * @brief assignment
+    *
+    * @return true : if the last line assigned its expression to a variable
+    * @return false : if it was only an expression
+    */
+   bool assignment() const { return assignment_; }
+
+   /**
+    * @brief target
+    * PRE: assignment()
+    *
+    * @return uint32_t : id of the variable that was assigned to
+    */
+   uint32_t target() const { return target_; }
+};
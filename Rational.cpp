@@ -0,0 +1,331 @@
+/**
+ * @file Rational.cpp
+ * @author Katarina McGaughy
+ * @brief The Rational class is an exact fraction of two BigInts. It is the
+ * value type of folded numbers, so division does not lose information.
+ * Fractions are reduced lazily, see Rational.h.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Rational.h"
+#include <algorithm>
+using namespace std;
+
+/**
+ * @brief Construct a new Rational object
+ * default constructor, the value is 0
+ */
+Rational::Rational() : num_(), den_(1), reduced_(true), reducedBits_(1)
+{
+}
+
+/**
+ * @brief Construct a new Rational object
+ *
+ * @param value : integer value
+ */
+Rational::Rational(int64_t value) : num_(value), den_(1), reduced_(true)
+{
+   reducedBits_ = bits();
+}
+
+/**
+ * @brief Construct a new Rational object
+ *
+ * @param value : integer value
+ */
+Rational::Rational(const BigInt &value) : num_(value), den_(1),
+                                          reduced_(true)
+{
+   reducedBits_ = bits();
+}
+
+/**
+ * @brief Construct a new Rational object
+ * PRE: den is not 0
+ *
+ * @param num : numerator
+ * @param den : denominator
+ */
+Rational::Rational(const BigInt &num, const BigInt &den) : num_(num),
+                                                           den_(den),
+                                                           reduced_(false),
+                                                           reducedBits_(0)
+{
+   if (den_.isNegative())
+   {
+      num_ = -num_;
+      den_ = -den_;
+   }
+   reduce();
+}
+
+/**
+ * @brief reduce
+ * this function divides numerator and denominator by their gcd. It does
+ * not change the value, so it can be called on a const fraction.
+ */
+void Rational::reduce() const
+{
+   if (reduced_)
+   {
+      return;
+   }
+   BigInt divisor = BigInt::gcd(num_, den_);
+   if (divisor.compare(BigInt(1)) > 0)
+   {
+      BigInt remainder;
+      BigInt::divMod(num_, divisor, num_, remainder);
+      BigInt::divMod(den_, divisor, den_, remainder);
+   }
+   reduced_ = true;
+   reducedBits_ = bits();
+}
+
+/**
+ * @brief settle
+ * this function reduces the fraction once it has grown to twice the
+ * size it had after the last reduction
+ *
+ * @param before : reducedBits_ of the operands
+ */
+void Rational::settle(size_t before)
+{
+   reducedBits_ = before;
+   // an integer is always reduced
+   reduced_ = den_.bitLength() == 1;
+   if (!reduced_ && bits() > 2 * reducedBits_ + 64)
+   {
+      reduce();
+   }
+}
+
+/**
+ * @brief numerator
+ *
+ * @return const BigInt& : numerator of the reduced fraction
+ */
+const BigInt &Rational::numerator() const
+{
+   reduce();
+   return num_;
+}
+
+/**
+ * @brief denominator
+ *
+ * @return const BigInt& : denominator of the reduced fraction
+ */
+const BigInt &Rational::denominator() const
+{
+   reduce();
+   return den_;
+}
+
+/**
+ * @brief isInteger
+ *
+ * @return true : if the denominator of the reduced fraction is 1
+ * @return false : if it is not
+ */
+bool Rational::isInteger() const
+{
+   reduce();
+   return den_.bitLength() == 1;
+}
+
+/**
+ * @brief fitsInt64
+ *
+ * @return true : if the value is an integer that fits in an int64_t
+ * @return false : if it is not
+ */
+bool Rational::fitsInt64() const
+{
+   return isInteger() && num_.fitsInt64();
+}
+
+/**
+ * @brief toInt64
+ * PRE: fitsInt64()
+ *
+ * @return int64_t : the value
+ */
+int64_t Rational::toInt64() const
+{
+   return num_.toInt64();
+}
+
+/**
+ * @brief toString
+ *
+ * @return string : "n" for an integer, "n/d" for a reduced fraction
+ */
+string Rational::toString() const
+{
+   if (isInteger())
+   {
+      return num_.toString();
+   }
+   return num_.toString() + "/" + den_.toString();
+}
+
+/**
+ * @brief compare
+ *
+ * @param rhs : fraction to compare with
+ * @return int : -1, 0 or 1 as this is less, equal or greater than rhs
+ */
+int Rational::compare(const Rational &rhs) const
+{
+   reduce();
+   rhs.reduce();
+   if (den_.compare(rhs.den_) == 0)
+   {
+      return num_.compare(rhs.num_);
+   }
+   return (num_ * rhs.den_).compare(rhs.num_ * den_);
+}
+
+Rational Rational::operator-() const
+{
+   Rational result = *this;
+   result.num_ = -num_;
+   return result;
+}
+
+Rational Rational::operator+(const Rational &rhs) const
+{
+   Rational result;
+   if (den_.compare(rhs.den_) == 0)
+   {
+      result.num_ = num_ + rhs.num_;
+      result.den_ = den_;
+   }
+   else
+   {
+      result.num_ = num_ * rhs.den_ + rhs.num_ * den_;
+      result.den_ = den_ * rhs.den_;
+   }
+   result.settle(max(reducedBits_, rhs.reducedBits_));
+   return result;
+}
+
+Rational Rational::operator-(const Rational &rhs) const
+{
+   return *this + -rhs;
+}
+
+Rational Rational::operator*(const Rational &rhs) const
+{
+   Rational result;
+   result.num_ = num_ * rhs.num_;
+   if (den_.bitLength() != 1 || rhs.den_.bitLength() != 1)
+   {
+      result.den_ = den_ * rhs.den_;
+   }
+   result.settle(max(reducedBits_, rhs.reducedBits_));
+   return result;
+}
+
+/**
+ * @brief divide
+ *
+ * @param a : dividend
+ * @param b : divisor
+ * @param quotient : a / b
+ * @return true : if the division could be done
+ * @return false : if b is 0
+ */
+bool Rational::divide(const Rational &a, const Rational &b,
+                      Rational &quotient)
+{
+   if (b.isZero())
+   {
+      return false;
+   }
+   Rational result;
+   result.num_ = a.num_ * b.den_;
+   result.den_ = a.den_ * b.num_;
+   if (result.den_.isNegative())
+   {
+      result.num_ = -result.num_;
+      result.den_ = -result.den_;
+   }
+   result.settle(max(a.reducedBits_, b.reducedBits_));
+   quotient = result;
+   return true;
+}
+
+/**
+ * @brief pow
+ * this function raises a fraction to an integer power
+ *
+ * @param base : base
+ * @param exponent : power, must be an integer
+ * @param maxBits : largest result that is computed, in bits
+ * @param result : base to the power of exponent
+ * @return true : if the power could be computed
+ * @return false : if the exponent is not an integer, 0 is raised to a
+ * negative power or the result would be larger than maxBits
+ */
+bool Rational::pow(const Rational &base, const Rational &exponent,
+                   size_t maxBits, Rational &result)
+{
+   if (!exponent.isInteger())
+   {
+      return false;
+   }
+   base.reduce();
+   const BigInt &e = exponent.num_;
+   bool negative = e.isNegative();
+   if (negative && base.isZero())
+   {
+      return false;
+   }
+
+   if (base.den_.bitLength() == 1 && base.num_.bitLength() <= 1)
+   {
+      // 0, 1 and -1 stay small for any exponent
+      if (base.isZero())
+      {
+         result = Rational(e.isZero() ? 1 : 0);
+      }
+      else
+      {
+         result = Rational(base.isNegative() && e.isOdd() ? -1 : 1);
+      }
+      return true;
+   }
+
+   if (e.bitLength() > 32)
+   {
+      return false;
+   }
+   uint64_t power = negative ? (-e).toInt64() : e.toInt64();
+   if ((base.bits() - 2) * power > maxBits)
+   {
+      return false;
+   }
+
+   Rational value;
+   value.num_ = base.num_.pow(power);
+   value.den_ = base.den_.pow(power);
+   if (negative)
+   {
+      swap(value.num_, value.den_);
+      if (value.den_.isNegative())
+      {
+         value.num_ = -value.num_;
+         value.den_ = -value.den_;
+      }
+   }
+   // powers of a reduced fraction are reduced
+   value.reduced_ = true;
+   value.reducedBits_ = value.bits();
+   result = value;
+   return true;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file Rational.h
+ * @author Katarina McGaughy
+ * @brief The Rational class is an exact fraction of two BigInts. It is the
+ * value type of folded numbers, so division does not lose information.
+ * Fractions are not reduced after every operation. They are reduced when
+ * they are printed or compared, or when they have grown to twice the size
+ * they had after the last reduction, so the cost of the gcd is amortized
+ * over long chains of operations.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <string>
+#include "BigInt.h"
+#pragma once
+using namespace std;
+
+class Rational
+{
+
+private:
+   // numerator, carries the sign
+   mutable BigInt num_;
+
+   // denominator, always positive
+   mutable BigInt den_;
+
+   // true if num_ and den_ have no common factor
+   mutable bool reduced_;
+
+   // size in bits when the fraction was last known to be reduced
+   mutable size_t reducedBits_;
+
+   /**
+    * @brief bits
+    *
+    * @return size_t : size of numerator and denominator in bits
+    */
+   size_t bits() const { return num_.bitLength() + den_.bitLength(); }
+
+   /**
+    * @brief settle
+    * this function reduces the fraction once it has grown to twice the
+    * size it had after the last reduction
+    *
+    * @param before : reducedBits_ of the operands
+    */
+   void settle(size_t before);
+
+public:
+   /**
+    * @brief Construct a new Rational object
+    * default constructor, the value is 0
+    */
+   Rational();
+
+   /**
+    * @brief Construct a new Rational object
+    *
+    * @param value : integer value
+    */
+   Rational(int64_t value);
+
+   /**
+    * @brief Construct a new Rational object
+    *
+    * @param value : integer value
+    */
+   Rational(const BigInt &value);
+
+   /**
+    * @brief Construct a new Rational object
+    * PRE: den is not 0
+    *
+    * @param num : numerator
+    * @param den : denominator
+    */
+   Rational(const BigInt &num, const BigInt &den);
+
+   /**
+    * @brief reduce
+    * this function divides numerator and denominator by their gcd. It does
+    * not change the value, so it can be called on a const fraction.
+    */
+   void reduce() const;
+
+   /**
+    * @brief numerator
+    *
+    * @return const BigInt& : numerator of the reduced fraction
+    */
+   const BigInt &numerator() const;
+
+   /**
+    * @brief denominator
+    *
+    * @return const BigInt& : denominator of the reduced fraction
+    */
+   const BigInt &denominator() const;
+
+   /**
+    * @brief isInteger
+    *
+    * @return true : if the denominator of the reduced fraction is 1
+    * @return false : if it is not
+    */
+   bool isInteger() const;
+
+   /**
+    * @brief isZero
+    *
+    * @return true : if the value is 0
+    * @return false : if it is not
+    */
+   bool isZero() const { return num_.isZero(); }
+
+   /**
+    * @brief isNegative
+    *
+    * @return true : if the value is less than 0
+    * @return false : if it is not
+    */
+   bool isNegative() const { return num_.isNegative(); }
+
+   /**
+    * @brief fitsInt64
+    *
+    * @return true : if the value is an integer that fits in an int64_t
+    * @return false : if it is not
+    */
+   bool fitsInt64() const;
+
+   /**
+    * @brief toInt64
+    * PRE: fitsInt64()
+    *
+    * @return int64_t : the value
+    */
+   int64_t toInt64() const;
+
+   /**
+    * @brief toString
+    *
+    * @return string : "n" for an integer, "n/d" for a reduced fraction
+    */
+   string toString() const;
+
+   /**
+    * @brief compare
+    *
+    * @param rhs : fraction to compare with
+    * @return int : -1, 0 or 1 as this is less, equal or greater than rhs
+    */
+   int compare(const Rational &rhs) const;
+
+   Rational operator-() const;
+   Rational operator+(const Rational &rhs) const;
+   Rational operator-(const Rational &rhs) const;
+   Rational operator*(const Rational &rhs) const;
+
+   /**
+    * @brief divide
+    *
+    * @param a : dividend
+    * @param b : divisor
+    * @param quotient : a / b
+    * @return true : if the division could be done
+    * @return false : if b is 0
+    */
+   static bool divide(const Rational &a, const Rational &b,
+                      Rational &quotient);
+
+   /**
+    * @brief pow
+    * this function raises a fraction to an integer power
+    *
+    * @param base : base
+    * @param exponent : power, must be an integer
+    * @param maxBits : largest result that is computed, in bits
+    * @param result : base to the power of exponent
+    * @return true : if the power could be computed
+    * @return false : if the exponent is not an integer, 0 is raised to a
+    * negative power or the result would be larger than maxBits
+    */
+   static bool pow(const Rational &base, const Rational &exponent,
+                   size_t maxBits, Rational &result);
+};
@@ -0,0 +1,99 @@
+/**
+ * @file SymbolTable.cpp
+ * @author Katarina McGaughy
+ * @brief The SymbolTable class holds the tree assigned to each variable,
+ * indexed by the interned id of the variable.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include <utility>
+using namespace std;
+
+/**
+ * @brief assign
+ * this function moves a tree into the table as the tree of a variable,
+ * replacing the tree it had. The values kept for the variables that depend
+ * on it, directly or through the values of other variables, are dropped,
+ * the others are kept. A value only records the variables its definition
+ * used, so the dropped values are followed from user to user, and only the
+ * users of a variable that changed are looked at.
+ *
+ * @param id : interned id of the variable
+ * @param tree : tree of the expression assigned to the variable, it is left
+ * empty
+ */
+void SymbolTable::assign(uint32_t id, AST &&tree)
+{
+   if (id >= trees_.size())
+   {
+      trees_.resize(id + 1);
+   }
+   trees_[id] = move(tree);
+
+   vector<uint32_t> changed(1, id);
+   while (!changed.empty())
+   {
+      uint32_t variable = changed.back();
+      changed.pop_back();
+      if (variable >= users_.size())
+      {
+         continue;
+      }
+      // every user either drops its value now or no longer depends on the
+      // variable, so the list is emptied
+      vector<uint32_t> users;
+      users.swap(users_[variable]);
+      for (size_t i = 0; i < users.size(); i++)
+      {
+         if (trees_[users[i]].invalidate(variable))
+         {
+            changed.push_back(users[i]);
+         }
+      }
+   }
+}
+
+/**
+ * @brief keep
+ * this function records the dependencies of the value that was just kept
+ * for a variable, so assigning one of them drops the value
+ *
+ * @param id : interned id of the variable
+ * @param dependencies : variables the value depends on, by interned id
+ */
+void SymbolTable::keep(uint32_t id, const vector<uint32_t> &dependencies)
+{
+   for (size_t i = 0; i < dependencies.size(); i++)
+   {
+      uint32_t variable = dependencies[i];
+      if (variable >= users_.size())
+      {
+         users_.resize(variable + 1);
+      }
+      vector<uint32_t> &users = users_[variable];
+      // a value that is kept again after being dropped for another
+      // variable is often already the last user
+      if (users.empty() || users.back() != id)
+      {
+         users.push_back(id);
+      }
+   }
+}
+
+/**
+ * @brief assign
+ * same as above with the variable given by name
+ *
+ * @param name : name of the variable
+ * @param tree : tree of the expression assigned to the variable, it is left
+ * empty
+ */
+void SymbolTable::assign(const string &name, AST &&tree)
+{
+   assign(Symbols::intern(name), move(tree));
+}
@@ -0,0 +1,100 @@
+/**
+ * @file SymbolTable.h
+ * @author Katarina McGaughy
+ * @brief The SymbolTable class holds the tree assigned to each variable. The
+ * trees are kept in a vector indexed by the interned id of the variable, so
+ * finding the tree of a variable is one index into the vector and never
+ * compares names. A variable that was never assigned has no tree and stands
+ * for itself.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AST.h"
+#pragma once
+using namespace std;
+
+class SymbolTable
+{
+
+private:
+   // tree of each variable indexed by interned id, empty for a variable
+   // that was never assigned
+   vector<AST> trees_;
+
+   // variables whose kept value depends on each variable, indexed by
+   // interned id. An entry can be stale once that value was dropped, it is
+   // skipped when the variable changes.
+   vector<vector<uint32_t> > users_;
+
+public:
+   /**
+    * @brief Construct a new SymbolTable object
+    * every variable starts without a tree
+    */
+   SymbolTable() {}
+
+   /**
+    * @brief find
+    *
+    * @param id : interned id of a variable
+    * @return AST* : tree assigned to the variable, nullptr if it has none
+    */
+   AST *find(uint32_t id)
+   {
+      return id < trees_.size() && !trees_[id].empty() ? &trees_[id]
+                                                       : nullptr;
+   }
+
+   /**
+    * @brief find
+    * same as above for a table that is not changed
+    *
+    * @param id : interned id of a variable
+    * @return const AST* : tree assigned to the variable, nullptr if it has
+    * none
+    */
+   const AST *find(uint32_t id) const
+   {
+      return id < trees_.size() && !trees_[id].empty() ? &trees_[id]
+                                                       : nullptr;
+   }
+
+   /**
+    * @brief assign
+    * this function moves a tree into the table as the tree of a variable,
+    * replacing the tree it had. The values kept for the variables that
+    * depend on it, directly or through the values of other variables, are
+    * dropped, the others are kept.
+    *
+    * @param id : interned id of the variable
+    * @param tree : tree of the expression assigned to the variable, it is
+    * left empty
+    */
+   void assign(uint32_t id, AST &&tree);
+
+   /**
+    * @brief assign
+    * same as above with the variable given by name
+    *
+    * @param name : name of the variable
+    * @param tree : tree of the expression assigned to the variable, it is
+    * left empty
+    */
+   void assign(const string &name, AST &&tree);
+
+   /**
+    * @brief keep
+    * this function records the dependencies of the value that was just kept
+    * for a variable, so assigning one of them drops the value
+    *
+    * @param id : interned id of the variable
+    * @param dependencies : variables the value depends on, by interned id
+    */
+   void keep(uint32_t id, const vector<uint32_t> &dependencies);
+};
@@ -0,0 +1,94 @@
+/**
+ * @file Symbols.cpp
+ * @author Katarina McGaughy
+ * @brief The Symbols class interns variable names. Every distinct name gets a
+ * small id that tokens and trees carry instead of the name itself. The
+ * letters a to z are interned first, so their ids are 0 to 25.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Symbols.h"
+using namespace std;
+
+/**
+ * @brief names
+ *
+ * @return vector<string>& : name of every id, indexed by id
+ */
+vector<string> &Symbols::names()
+{
+   static vector<string> names = []()
+   {
+      vector<string> letters;
+      for (char c = 'a'; c <= 'z'; c++)
+      {
+         letters.push_back(string(1, c));
+      }
+      return letters;
+   }();
+   return names;
+}
+
+/**
+ * @brief ids
+ *
+ * @return unordered_map<string, uint32_t>& : id of every name
+ */
+unordered_map<string, uint32_t> &Symbols::ids()
+{
+   static unordered_map<string, uint32_t> ids = []()
+   {
+      unordered_map<string, uint32_t> letters;
+      for (uint32_t i = 0; i < names().size(); i++)
+      {
+         letters[names()[i]] = i;
+      }
+      return letters;
+   }();
+   return ids;
+}
+
+/**
+ * @brief intern
+ * this function returns the id of a name, giving the name a new id the
+ * first time it is seen
+ *
+ * @param name : variable name
+ * @return uint32_t : id of the name
+ */
+uint32_t Symbols::intern(const string &name)
+{
+   unordered_map<string, uint32_t>::iterator it = ids().find(name);
+   if (it != ids().end())
+   {
+      return it->second;
+   }
+   uint32_t id = names().size();
+   names().push_back(name);
+   ids()[name] = id;
+   return id;
+}
+
+/**
+ * @brief name
+ *
+ * @param id : id of a name
+ * @return const string& : the name
+ */
+const string &Symbols::name(uint32_t id)
+{
+   return names()[id];
+}
+
+/**
+ * @brief size
+ *
+ * @return size_t : number of interned names
+ */
+size_t Symbols::size()
+{
+   return names().size();
+}
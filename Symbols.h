@@ -0,0 +1,71 @@
+/**
+ * @file Symbols.h
+ * @author Katarina McGaughy
+ * @brief The Symbols class interns variable names. Every distinct name gets a
+ * small id that tokens and trees carry instead of the name itself. The
+ * letters a to z are interned first, so their ids are 0 to 25.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#pragma once
+using namespace std;
+
+class Symbols
+{
+
+private:
+   /**
+    * @brief names
+    *
+    * @return vector<string>& : name of every id, indexed by id
+    */
+   static vector<string> &names();
+
+   /**
+    * @brief ids
+    *
+    * @return unordered_map<string, uint32_t>& : id of every name
+    */
+   static unordered_map<string, uint32_t> &ids();
+
+public:
+   /**
+    * @brief intern
+    * this function returns the id of a name, giving the name a new id the
+    * first time it is seen
+    *
+    * @param name : variable name
+    * @return uint32_t : id of the name
+    */
+   static uint32_t intern(const string &name);
+
+   /**
+    * @brief letter
+    *
+    * @param c : lowercase letter
+    * @return uint32_t : id of the single letter name c
+    */
+   static uint32_t letter(char c) { return c - 'a'; }
+
+   /**
+    * @brief name
+    *
+    * @param id : id of a name
+    * @return const string& : the name
+    */
+   static const string &name(uint32_t id);
+
+   /**
+    * @brief size
+    *
+    * @return size_t : number of interned names
+    */
+   static size_t size();
+};
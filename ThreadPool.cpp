@@ -0,0 +1,182 @@
+/**
+ * @file ThreadPool.cpp
+ * @author Katarina McGaughy
+ * @brief The ThreadPool class runs a loop over a range of indexes on several
+ * threads, balancing the chunks of the range by work stealing.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "ThreadPool.h"
+using namespace std;
+
+/**
+ * @brief Construct a new ThreadPool object
+ * starts the workers, they sleep until a loop is run
+ *
+ * @param threads : number of workers, 0 for one per hardware thread
+ */
+ThreadPool::ThreadPool(size_t threads) : body_(nullptr), queued_(0),
+                                         pending_(0), stopping_(false)
+{
+   if (threads == 0)
+   {
+      threads = thread::hardware_concurrency();
+   }
+   if (threads == 0)
+   {
+      threads = 1;
+   }
+   for (size_t i = 0; i < threads; i++)
+   {
+      queues_.push_back(unique_ptr<Queue>(new Queue()));
+   }
+   for (size_t i = 0; i < threads; i++)
+   {
+      threads_.push_back(thread(&ThreadPool::workerLoop, this, i));
+   }
+}
+
+/**
+ * @brief Destroy the ThreadPool object
+ * stops and joins the workers
+ */
+ThreadPool::~ThreadPool()
+{
+   {
+      lock_guard<mutex> guard(stateLock_);
+      stopping_ = true;
+   }
+   wake_.notify_all();
+   for (int i = 0; i < threads_.size(); i++)
+   {
+      threads_[i].join();
+   }
+}
+
+/**
+ * @brief parallelFor
+ * this function calls body on chunks of [begin, end) on the workers and
+ * returns when every chunk has finished. Each worker is given a run of
+ * neighbouring chunks so it walks through memory in order until it has to
+ * steal.
+ *
+ * @param begin : first index
+ * @param end : one past the last index
+ * @param grain : number of indexes in a chunk, the last chunk may be
+ * shorter
+ * @param body : called with the bounds of each chunk
+ */
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain,
+                             const Body &body)
+{
+   if (begin >= end)
+   {
+      return;
+   }
+   if (grain == 0)
+   {
+      grain = 1;
+   }
+   lock_guard<mutex> loop(loopLock_);
+
+   size_t chunks = (end - begin + grain - 1) / grain;
+   size_t workers = queues_.size();
+   body_ = &body;
+   pending_ = chunks;
+   for (size_t w = 0; w < workers; w++)
+   {
+      // chunks [first, last) go to worker w
+      size_t first = chunks * w / workers;
+      size_t last = chunks * (w + 1) / workers;
+      lock_guard<mutex> guard(queues_[w]->lock);
+      for (size_t c = first; c < last; c++)
+      {
+         size_t chunkBegin = begin + c * grain;
+         size_t chunkEnd = end - chunkBegin < grain ? end : chunkBegin + grain;
+         // the owner takes from the back, so the first chunk goes last
+         queues_[w]->chunks.push_front(Chunk{chunkBegin, chunkEnd});
+      }
+   }
+
+   unique_lock<mutex> state(stateLock_);
+   queued_ = chunks;
+   wake_.notify_all();
+   done_.wait(state, [this]() { return pending_ == 0; });
+   body_ = nullptr;
+}
+
+/**
+ * @brief workerLoop
+ * this function is run by every worker. It runs chunks until the pool
+ * stops and sleeps while there is nothing to run.
+ *
+ * @param index : index of the worker and of its queue
+ */
+void ThreadPool::workerLoop(size_t index)
+{
+   while (true)
+   {
+      {
+         unique_lock<mutex> state(stateLock_);
+         wake_.wait(state, [this]() { return stopping_ || queued_ > 0; });
+         if (stopping_)
+         {
+            return;
+         }
+      }
+
+      Chunk chunk;
+      while (takeChunk(index, chunk))
+      {
+         {
+            lock_guard<mutex> state(stateLock_);
+            queued_--;
+         }
+         (*body_)(chunk.begin, chunk.end);
+         if (--pending_ == 0)
+         {
+            lock_guard<mutex> state(stateLock_);
+            done_.notify_all();
+         }
+      }
+   }
+}
+
+/**
+ * @brief takeChunk
+ * this function takes a chunk from the back of the worker's own queue or
+ * steals one from the front of another queue
+ *
+ * @param index : index of the worker
+ * @param chunk : the chunk that was taken
+ * @return true : if a chunk was taken
+ * @return false : if every queue is empty
+ */
+bool ThreadPool::takeChunk(size_t index, Chunk &chunk)
+{
+   {
+      Queue &own = *queues_[index];
+      lock_guard<mutex> guard(own.lock);
+      if (!own.chunks.empty())
+      {
+         chunk = own.chunks.back();
+         own.chunks.pop_back();
+         return true;
+      }
+   }
+   for (size_t i = 1; i < queues_.size(); i++)
+   {
+      Queue &victim = *queues_[(index + i) % queues_.size()];
+      lock_guard<mutex> guard(victim.lock);
+      if (!victim.chunks.empty())
+      {
+         chunk = victim.chunks.front();
+         victim.chunks.pop_front();
+         return true;
+      }
+   }
+   return false;
+}
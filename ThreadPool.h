@@ -0,0 +1,145 @@
+/**
+ * @file ThreadPool.h
+ * @author Katarina McGaughy
+ * @brief The ThreadPool class runs a loop over a range of indexes on several
+ * threads. The range is cut into chunks and each worker gets a deque of
+ * neighbouring chunks. A worker takes chunks from the back of its own deque
+ * and, once that is empty, steals from the front of the other deques, so a
+ * worker whose chunks turn out to be cheap helps the ones whose chunks are
+ * expensive.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#pragma once
+using namespace std;
+
+class ThreadPool
+{
+
+public:
+   // body of a loop, called with a chunk [begin, end) of the range
+   typedef function<void(size_t, size_t)> Body;
+
+private:
+   /**
+    * @brief Chunk
+    * a part of the range of the loop that is being run
+    */
+   struct Chunk
+   {
+      size_t begin;
+      size_t end;
+   };
+
+   /**
+    * @brief Queue
+    * the chunks of one worker, other workers steal from the front
+    */
+   struct Queue
+   {
+      mutex lock;
+      deque<Chunk> chunks;
+   };
+
+   // one queue per worker
+   vector<unique_ptr<Queue> > queues_;
+
+   // the worker threads
+   vector<thread> threads_;
+
+   // body of the loop that is being run
+   const Body *body_;
+
+   // chunks that have been queued but not taken by a worker yet
+   size_t queued_;
+
+   // chunks that have not finished yet
+   atomic<size_t> pending_;
+
+   // true when the workers should exit
+   bool stopping_;
+
+   // guards queued_, stopping_ and the condition variables
+   mutex stateLock_;
+
+   // signalled when chunks are queued or the pool stops
+   condition_variable wake_;
+
+   // signalled when the last chunk of a loop finishes
+   condition_variable done_;
+
+   // only one loop runs at a time
+   mutex loopLock_;
+
+   /**
+    * @brief workerLoop
+    * this function is run by every worker. It runs chunks until the pool
+    * stops and sleeps while there is nothing to run.
+    *
+    * @param index : index of the worker and of its queue
+    */
+   void workerLoop(size_t index);
+
+   /**
+    * @brief takeChunk
+    * this function takes a chunk from the back of the worker's own queue or
+    * steals one from the front of another queue
+    *
+    * @param index : index of the worker
+    * @param chunk : the chunk that was taken
+    * @return true : if a chunk was taken
+    * @return false : if every queue is empty
+    */
+   bool takeChunk(size_t index, Chunk &chunk);
+
+public:
+   /**
+    * @brief Construct a new ThreadPool object
+    * starts the workers, they sleep until a loop is run
+    *
+    * @param threads : number of workers, 0 for one per hardware thread
+    */
+   explicit ThreadPool(size_t threads = 0);
+
+   /**
+    * @brief Destroy the ThreadPool object
+    * stops and joins the workers
+    */
+   ~ThreadPool();
+
+   ThreadPool(const ThreadPool &) = delete;
+   ThreadPool &operator=(const ThreadPool &) = delete;
+
+   /**
+    * @brief size
+    *
+    * @return size_t : number of workers
+    */
+   size_t size() const { return threads_.size(); }
+
+   /**
+    * @brief parallelFor
+    * this function calls body on chunks of [begin, end) on the workers and
+    * returns when every chunk has finished. Each index is in exactly one
+    * chunk. body must not throw.
+    *
+    * @param begin : first index
+    * @param end : one past the last index
+    * @param grain : number of indexes in a chunk, the last chunk may be
+    * shorter
+    * @param body : called with the bounds of each chunk
+    */
+   void parallelFor(size_t begin, size_t end, size_t grain, const Body &body);
+};
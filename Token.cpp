@@ -0,0 +1,114 @@
+/**
+ * @file Token.cpp
+ * @author Katarina McGaughy
+ * @brief The Token struct creates a Token object that has a type TokenType,
+ * an Opcode for operators, an interned id for variables and a value for
+ * numbers.
+ * @version 0.1
+ * @date 2021-12-06
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Token.h"
+#include "Symbols.h"
+using namespace std;
+
+/**
+ * @brief opcodeSymbol
+ *
+ * @param op : opcode
+ * @return char : the character that is written for the operation
+ */
+char opcodeSymbol(Opcode op)
+{
+   static const char symbols[] = {'?', '+', '-', '*', '/', '^'};
+   return symbols[op];
+}
+
+/**
+ * @brief opcodePrecedence
+ *
+ * @param op : opcode
+ * @return int : precedence rank of the operation, higher binds tighter, -1
+ * for no operation
+ */
+int opcodePrecedence(Opcode op)
+{
+   static const int ranks[] = {-1, 1, 1, 2, 2, 3};
+   return ranks[op];
+}
+
+/**
+ * @brief fromNumber
+ *
+ * @param n : value of the number
+ * @return Token : a number token
+ */
+Token Token::fromNumber(int64_t n)
+{
+   Token t = Token(number);
+   t.number_ = n;
+   return t;
+}
+
+/**
+ * @brief fromVariable
+ *
+ * @param id : interned id of the variable name
+ * @return Token : a variable token
+ */
+Token Token::fromVariable(uint32_t id)
+{
+   Token t = Token(variable);
+   t.id_ = id;
+   return t;
+}
+
+/**
+ * @brief fromBigNumber
+ *
+ * @param id : index of the value in the TokenStream that read the number
+ * @return Token : a number token
+ */
+Token Token::fromBigNumber(uint32_t id)
+{
+   Token t = Token(number);
+   t.big_ = true;
+   t.id_ = id;
+   return t;
+}
+
+/**
+ * @brief toString
+ *
+ * @return string : the text the token was read from, empty for a number
+ * that does not fit, whose text is given by TokenStream::text
+ */
+string Token::toString() const
+{
+   switch (type_)
+   {
+   case binop:
+   case powop:
+      return string(1, opcodeSymbol(op_));
+   case variable:
+      return Symbols::name(id_);
+   case number:
+      return big_ ? string() : to_string(number_);
+   case lparen:
+      return "(";
+   case rparen:
+      return ")";
+   case assignop:
+      return ":=";
+   case ending:
+      return ".";
+   case eol:
+      return "\n";
+   case invalid:
+      return "invalid";
+   default:
+      return "unknown";
+   }
+}
@@ -4,7 +4,10 @@
  * @brief The Token class contains an enum called TokenType which creates types
  * for the tokens to be initialized with. The types consist of various
  * characters that exist in an expression along with a few other types. The
- * Token struct creates a Token object that has a type TokenType and a string.
+ * Token struct creates a Token object that has a type TokenType, an Opcode
+ * for operators, an interned id for variables and a value for numbers. A
+ * Token holds no string, only the position of its text in the line it was
+ * read from, so it is 16 bytes and trivially copyable.
  * @version 0.1
  * @date 2021-12-06
  *
@@ -12,8 +15,10 @@
  *
  */
 
+#include <cstdint>
 #include <string>
 #include <iostream>
+#include <type_traits>
 #pragma once
 using namespace std;
 
@@ -22,7 +27,7 @@ using namespace std;
  * Enum that contains the types of Tokens that will be created from the
  * istream
  */
-enum TokenType
+enum TokenType : unsigned char
 {
    binop,
    variable,
@@ -38,6 +43,37 @@ enum TokenType
 
 };
 
+/**
+ * @brief Opcode
+ * Enum that contains the operation of a binop or powop Token
+ */
+enum Opcode : unsigned char
+{
+   opNone,
+   opAdd,
+   opSub,
+   opMul,
+   opDiv,
+   opPow
+};
+
+/**
+ * @brief opcodeSymbol
+ *
+ * @param op : opcode
+ * @return char : the character that is written for the operation
+ */
+char opcodeSymbol(Opcode op);
+
+/**
+ * @brief opcodePrecedence
+ *
+ * @param op : opcode
+ * @return int : precedence rank of the operation, higher binds tighter, -1
+ * for no operation
+ */
+int opcodePrecedence(Opcode op);
+
 /**
  * @brief Token
  * This struct creates a Token
@@ -50,20 +86,80 @@ struct Token
     * @brief Construct a new Token object
     *
     * @param t : TokenType
-    * @param v :string of tokens
+    * @param op : operation of a binop or powop token
     */
-   Token(TokenType t, string v) : type_(t), value_(v){};
+   Token(TokenType t, Opcode op = opNone) : type_(t), op_(op), length_(0),
+                                            big_(false), offset_(0),
+                                            number_(0){};
 
    /**
     * @brief Construct a new Token object
-    * default constructor that sets type and value to unknown
+    * default constructor that sets type to unknown
+    *
+    */
+   Token() : type_(unknown), op_(opNone), length_(0), big_(false),
+             offset_(0), number_(0) {}
+
+   /**
+    * @brief fromNumber
+    *
+    * @param n : value of the number
+    * @return Token : a number token
+    */
+   static Token fromNumber(int64_t n);
+
+   /**
+    * @brief fromVariable
+    *
+    * @param id : interned id of the variable name
+    * @return Token : a variable token
+    */
+   static Token fromVariable(uint32_t id);
+
+   /**
+    * @brief fromBigNumber
+    *
+    * @param id : index of the value in the TokenStream that read the number
+    * @return Token : a number token
+    */
+   static Token fromBigNumber(uint32_t id);
+
+   /**
+    * @brief toString
     *
+    * @return string : the text the token was read from, empty for a number
+    * that does not fit, whose text is given by TokenStream::text
     */
-   Token() : type_(unknown), value_("unknown") {}
+   string toString() const;
 
    // token type from enum
    TokenType type_;
 
-   // token value
-   string value_;
-};
\ No newline at end of file
+   // operation of a binop or powop token
+   Opcode op_;
+
+   // number of characters the token was read from
+   uint16_t length_ : 15;
+
+   // true for a number token that does not fit in number_, whose id_ is
+   // then the index of its value in the TokenStream that read it
+   uint16_t big_ : 1;
+
+   // position of the first character of the token in its line
+   uint32_t offset_;
+
+   // a token holds a value or an id, never both
+   union
+   {
+      // value of a number token
+      int64_t number_;
+
+      // interned id of a variable token, or the index of the value of a big
+      // number token
+      uint32_t id_;
+   };
+};
+
+static_assert(sizeof(Token) <= 16, "Token should fit in 16 bytes");
+static_assert(is_trivially_copyable<Token>::value,
+              "Token should be trivially copyable");
@@ -1,8 +1,8 @@
 /**
  * @file TokenStream.cpp
  * @author Katarina McGaughy
- * @brief The TokenStream wraps the istream and converts various characters
- * into specific Tokens.
+ * @brief The TokenStream converts the characters of a line into specific
+ * Tokens, lexing the line in place.
  * @version 0.1
  * @date 2021-12-06
  *
@@ -11,125 +11,461 @@
  */
 #include <iostream>
 #include "TokenStream.h"
+#include "Symbols.h"
+#include "Rational.h"
 #include <cassert>
+#include <cctype>
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 using namespace std;
 
+/**
+ * @brief digitMask
+ * this function classifies the next 32 characters at once, bit i of the
+ * result is set if p[i] is a digit. AVX2 compares all 32 bytes in one
+ * register, SSE2 in two and other machines one byte at a time. Characters
+ * past end are read as not digits, so the mask never runs off the line.
+ *
+ * @param p : first character
+ * @param end : one past the last character of the line
+ * @return uint32_t : mask of the digits
+ */
+static uint32_t digitMask(const char *p, const char *end)
+{
+   char padded[32];
+   if (end - p < 32)
+   {
+      memset(padded, 0, sizeof(padded));
+      memcpy(padded, p, end - p);
+      p = padded;
+   }
+#if defined(__AVX2__)
+   __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+   __m256i digit = _mm256_and_si256(
+       _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+   return uint32_t(_mm256_movemask_epi8(digit));
+#elif defined(__SSE2__)
+   uint32_t mask = 0;
+   for (int half = 0; half < 2; half++)
+   {
+      __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p) + half);
+      __m128i digit = _mm_and_si128(
+          _mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+          _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+      mask |= uint32_t(_mm_movemask_epi8(digit)) << (16 * half);
+   }
+   return mask;
+#else
+   uint32_t mask = 0;
+   for (int i = 0; i < 32; i++)
+   {
+      mask |= uint32_t(p[i] >= '0' && p[i] <= '9') << i;
+   }
+   return mask;
+#endif
+}
+
+/**
+ * @brief digitRun
+ *
+ * @param p : first character
+ * @param end : one past the last character of the line
+ * @return size_t : number of digits that start at p
+ */
+static size_t digitRun(const char *p, const char *end)
+{
+   size_t length = 0;
+   while (p + length < end)
+   {
+      uint32_t others = ~digitMask(p + length, end);
+      if (others != 0)
+      {
+         return length + __builtin_ctz(others);
+      }
+      length += 32;
+   }
+   return end - p;
+}
+
+/**
+ * @brief fewDigits
+ * this function computes the value of up to 8 digits at once by combining
+ * pairs of neighbouring digits, then pairs of pairs, inside one 64 bit word.
+ * The word is shifted so the digits are the last ones of 8, the bytes in
+ * front of them are read as '0'. There is no branch on the number of
+ * digits, which is different for every number.
+ * PRE: 8 characters can be read at p
+ *
+ * @param p : first digit
+ * @param count : number of digits, 0 to 8
+ * @return uint64_t : their value
+ */
+static uint64_t fewDigits(const char *p, size_t count)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+   const uint64_t zeros = 0x3030303030303030ULL;
+   uint64_t word;
+   memcpy(&word, p, 8);
+   // each shift is split in two halves so a shift by 64 is defined
+   size_t shift = 8 * (8 - count);
+   size_t fill = 64 - shift;
+   word = ((word << (shift / 2)) << (shift - shift / 2)) |
+          ((zeros >> (fill / 2)) >> (fill - fill / 2));
+   word -= zeros;
+   word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+   word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+   return (word * 10000 + (word >> 32)) & 0xFFFFFFFFULL;
+#else
+   uint64_t value = 0;
+   for (size_t i = 0; i < count; i++)
+   {
+      value = value * 10 + (p[i] - '0');
+   }
+   return value;
+#endif
+}
+
+/**
+ * @brief numberToken
+ * this function makes the token of a run of digits. Runs of up to 18
+ * digits always fit in an int64_t and are computed 8 digits at a time, up
+ * to 16 digits with no branch on their number when the line is long enough
+ * to read 16 characters. Longer runs are checked for overflow and become a
+ * BigInt if they do not fit, whose value is kept with the line.
+ *
+ * @param digits : first digit
+ * @param count : number of digits
+ * @param end : one past the last character of the line
+ * @param numbers : values of the numbers of the line that do not fit
+ * @return Token : the number
+ */
+static Token numberToken(const char *digits, size_t count, const char *end,
+                         vector<Rational> &numbers)
+{
+   static const int64_t powers[] = {1, 10, 100, 1000, 10000, 100000,
+                                    1000000, 10000000, 100000000};
+   int64_t value = 0;
+   if (count <= 16 && digits + 16 <= end)
+   {
+      // the last 8 digits and the ones in front of them, which may be none
+      size_t front = count > 8 ? count - 8 : 0;
+      size_t back = count - front;
+      value = int64_t(fewDigits(digits, front)) * 100000000 +
+              int64_t(fewDigits(digits + front, back));
+      return Token::fromNumber(value);
+   }
+   if (count <= 18)
+   {
+      size_t i = 0;
+      while (i < count)
+      {
+         size_t group = count - i < 8 ? count - i : 8;
+         if (digits + i + 8 > end)
+         {
+            // too close to the end of the line to read a whole word
+            for (; i < count; i++)
+            {
+               value = value * 10 + (digits[i] - '0');
+            }
+            break;
+         }
+         value = value * powers[group] + int64_t(fewDigits(digits + i, group));
+         i += group;
+      }
+      return Token::fromNumber(value);
+   }
+   for (size_t i = 0; i < count; i++)
+   {
+      if (__builtin_mul_overflow(value, 10, &value) ||
+          __builtin_add_overflow(value, digits[i] - '0', &value))
+      {
+         numbers.push_back(BigInt::fromDigits(digits, count));
+         return Token::fromBigNumber(numbers.size() - 1);
+      }
+   }
+   return Token::fromNumber(value);
+}
+
+/**
+ * @brief makeCharTokens
+ * this function builds the token of every character that is a token by
+ * itself, digits and ':' are lexed separately. The table takes the place of
+ * a switch on the character.
+ *
+ * @return vector<Token> : 256 tokens indexed by unsigned char
+ */
+static vector<Token> makeCharTokens()
+{
+   vector<Token> tokens(256, Token(invalid));
+   tokens['.'] = Token(ending);
+   tokens['('] = Token(lparen);
+   tokens[')'] = Token(rparen);
+   tokens['+'] = Token(binop, opAdd);
+   tokens['-'] = Token(binop, opSub);
+   tokens['/'] = Token(binop, opDiv);
+   tokens['*'] = Token(binop, opMul);
+   tokens['^'] = Token(powop, opPow);
+   tokens['\n'] = Token(eol);
+   for (int c = 0; c < 256; c++)
+   {
+      if (isalpha(c))
+      {
+         // single letters are interned in order
+         tokens[c] = Token::fromVariable(Symbols::letter(tolower(c)));
+      }
+   }
+   return tokens;
+}
+
+// token of every character that is a token by itself
+static const vector<Token> charTokens = makeCharTokens();
+
+
 /**
  * @brief Construct a new Token Stream object
- * constructor that initializes the istream object and sets numCharsAdvances_
- * to 0
+ * constructor that reads the input stream a line at a time
  * @param inputStream : istream object
  */
-TokenStream::TokenStream(istream &inputStream) : is_(inputStream),
-                                                 numCharsAdvanced_(0)
+TokenStream::TokenStream(istream &inputStream)
+    : is_(&inputStream), begin_(nullptr), cursor_(nullptr), end_(nullptr)
 {
 }
 
 /**
- * operator>>
- * this function takes in the input stream and initializes tokens
- * based on the characters from the input stream
+ * @brief Construct a new Token Stream object
+ * constructor that lexes a line that is already in memory. The characters
+ * are not copied, they have to outlive the stream.
+ * @param begin : first character of the line
+ * @param end : one past the last character of the line
+ */
+TokenStream::TokenStream(const char *begin, const char *end)
+    : is_(nullptr), begin_(begin), cursor_(begin), end_(end)
+{
+}
+
+/**
+ * @brief fill
+ * this function reads the next line of the stream once the current line
+ * has been lexed. The end of the stream reads as a line that is a . so the
+ * calculator stops there.
  *
- * @param rhs : token
- * @return TokenStream&: istream
+ * @return true : if there is a character to lex
+ * @return false : at the end of a line that was given in memory
  */
-TokenStream &TokenStream::operator>>(Token &rhs)
+bool TokenStream::fill()
 {
-   string value;
-   char c;
-
-   is_.get(c);
-   numCharsAdvanced_ = 1;
-
-   switch (c)
-   {
-      // when to use breaks in case
-   case '.':
-      rhs = Token(ending, ".");
-      break;
-   case 40:
-      rhs = Token(lparen, "(");
-      break;
-   case 41:
-      rhs = Token(rparen, ")");
-      break;
-   case '+':
-      rhs = Token(binop, "+");
-      break;
-   case '-':
-      rhs = Token(binop, "-");
-      break;
-   case '/':
-      rhs = Token(binop, "/");
-      break;
-   case '*':
-      rhs = Token(binop, "*");
-      break;
-   case '^':
-      rhs = Token(powop, "^");
-      break;
-   case ':':
-      if (is_.peek() == '=')
+   if (cursor_ != end_)
+   {
+      return true;
+   }
+   if (is_ == nullptr)
+   {
+      return false;
+   }
+   if (!getline(*is_, line_))
+   {
+      line_ = ".";
+   }
+   line_ += '\n';
+   numbers_.clear();
+   begin_ = line_.data();
+   cursor_ = begin_;
+   end_ = begin_ + line_.size();
+   return true;
+}
+
+/**
+ * @brief lex
+ * this function reads the token that starts at cursor and moves cursor
+ * past it. Looking ahead is only a read of the next character, nothing has
+ * to be given back.
+ *
+ * @param cursor : next character to lex
+ * @param rhs : the token that was read
+ */
+void TokenStream::lex(const char *&cursor, Token &rhs)
+{
+   const char *start = cursor;
+   unsigned char c = *cursor;
+
+   if (isdigit(c))
+   {
+      size_t count = digitRun(cursor, end_);
+      rhs = numberToken(cursor, count, end_, numbers_);
+      cursor += count;
+   }
+   else if (charTokens[c].type_ == variable)
+   {
+      // a name is a run of letters, a single letter has its token ready
+      cursor++;
+      while (cursor != end_ &&
+             charTokens[static_cast<unsigned char>(*cursor)].type_ == variable)
       {
-         is_.get(c);
-         numCharsAdvanced_++;
-         rhs = Token(assignop, ":=");
+         cursor++;
       }
-      else
+      if (cursor - start == 1)
       {
-         rhs = Token(invalid, "invalid");
+         rhs = charTokens[c];
       }
-      break;
-   default:
-      if (isdigit(c))
+      else
       {
-         value += c;
-         while (isdigit(is_.peek()))
+         string name(start, cursor);
+         for (size_t i = 0; i < name.size(); i++)
          {
-            is_.get(c);
-            numCharsAdvanced_++;
-            value += c;
+            name[i] = tolower(static_cast<unsigned char>(name[i]));
          }
-         rhs = Token(number, value);
+         rhs = Token::fromVariable(Symbols::intern(name));
       }
-      else if (isalpha(c))
+   }
+   else if (c == ':')
+   {
+      cursor++;
+      if (cursor != end_ && *cursor == '=')
       {
-         string var;
-         // make character lowercase and add to string
-         var = tolower(c);
-         rhs = Token(variable, var);
+         cursor++;
+         rhs = Token(assignop);
       }
-      else if (c == '\n')
+      else
       {
-         rhs = Token(eol, "\n");
+         rhs = Token(invalid);
       }
-      else
+   }
+   else
+   {
+      cursor++;
+      rhs = charTokens[c];
+   }
+   rhs.offset_ = start - begin_;
+   rhs.length_ = cursor - start;
+}
+
+/**
+ * operator>>
+ * this function reads the next token. A token records where its text is
+ * in the line it was read from. The end of a line that was given in memory
+ * reads as an eol token.
+ *
+ * @param rhs : token
+ * @return TokenStream&: this stream
+ */
+TokenStream &TokenStream::operator>>(Token &rhs)
+{
+   if (!fill())
+   {
+      rhs = Token(eol);
+      return *this;
+   }
+   lex(cursor_, rhs);
+   return *this;
+}
+
+/**
+ * operator>>
+ * this function reads the tokens up to and including the next eol. The line
+ * is classified 32 characters at a time: every character that is not a
+ * digit starts a token, and so does every digit that follows a non digit.
+ * A run of digits that ends inside the block is read with its length taken
+ * straight from the mask.
+ *
+ * @param line : the tokens are appended to it
+ * @return TokenStream&: this stream
+ */
+TokenStream &TokenStream::operator>>(vector<Token> &line)
+{
+   while (fill())
+   {
+      const char *block = cursor_;
+      uint32_t digits = digitMask(block, end_);
+      uint32_t inside = end_ - block < 32 ? (1u << (end_ - block)) - 1
+                                          : ~0u;
+      uint32_t starts = (~digits | (digits & ~(digits << 1))) & inside;
+      while (starts != 0)
       {
-         rhs = Token(invalid, "invalid");
+         const char *start = block + __builtin_ctz(starts);
+         starts &= starts - 1;
+         if (start < cursor_)
+         {
+            // part of a token that was already read, such as the = of :=
+            continue;
+         }
+         cursor_ = start;
+         // the digits from start on, the bits past the block read as
+         // non digits. A block that is all digits has no such bit.
+         uint32_t others = ~(digits >> (start - block));
+         size_t count = others == 0 ? 32 : __builtin_ctz(others);
+         if (count > 0 && start + count < block + 32)
+         {
+            // the position is set after the token is in the vector, so the
+            // token is not copied again
+            line.push_back(numberToken(start, count, end_, numbers_));
+            line.back().offset_ = start - begin_;
+            line.back().length_ = count;
+            cursor_ += count;
+            continue;
+         }
+         unsigned char c = *start;
+         // a letter followed by a letter starts a longer name
+         bool name = charTokens[c].type_ == variable && start + 1 != end_ &&
+                     charTokens[static_cast<unsigned char>(start[1])].type_ ==
+                         variable;
+         if ((c < '0' || c > '9') && c != ':' && !name)
+         {
+            line.push_back(charTokens[c]);
+            line.back().offset_ = start - begin_;
+            line.back().length_ = 1;
+            cursor_++;
+         }
+         else
+         {
+            line.push_back(Token());
+            lex(cursor_, line.back());
+         }
+         if (line.back().type_ == eol)
+         {
+            return *this;
+         }
       }
    }
+   line.push_back(Token(eol));
    return *this;
 }
 
+/**
+ * @brief text
+ *
+ * @param t : a token read from this stream
+ * @return string : the text of the token
+ */
+string TokenStream::text(const Token &t) const
+{
+   if (t.type_ == number && t.big_)
+   {
+      return numbers_[t.id_].toString();
+   }
+   return t.toString();
+}
+
 /**
  * @brief explicit type converter to a bool which is used to test
  * if there is an error in the input stream
- * @return true : returns true if there are no erros
+ * @return true : returns true if the next token is not invalid
  * @return false : returns false if errors exist
  */
 TokenStream::operator bool() const
 {
-   Token token;
    TokenStream *nc_this = const_cast<TokenStream *>(this);
-
-   nc_this->operator>>(token);
-
-   // Unget however many characters that operator>> advanced.
-   for (int i = 0; i < numCharsAdvanced_; ++i)
+   if (!nc_this->fill())
    {
-      nc_this->is_.unget();
+      return true;
    }
-   nc_this->numCharsAdvanced_ = 0;
+
+   // lex from a copy of the cursor, so the token is read again by >>
+   const char *cursor = cursor_;
+   Token token;
+   nc_this->lex(cursor, token);
 
    if (token.type_ == invalid)
       return false;
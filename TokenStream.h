@@ -1,8 +1,11 @@
 /**
  * @file TokenStream.h
  * @author Katarina McGaughy
- * @brief The TokenStream wraps the istream and converts various characters
- * into specific Tokens.
+ * @brief The TokenStream converts the characters of a line into specific
+ * Tokens. It reads a range of characters that is already in memory in place,
+ * so lexing a line copies nothing, and it looks ahead by moving a cursor
+ * instead of giving characters back to a stream. Digits are found 32
+ * characters at a time and numbers are computed 8 digits at a time.
  * @version 0.1
  * @date 2021-12-06
  *
@@ -10,42 +13,118 @@
  *
  */
 #include <iostream>
+#include <string>
+#include <vector>
 #include "Token.h"
+#include "Rational.h"
 #pragma once
 
 class TokenStream
 {
 
 private:
-   // istream object
-   istream &is_;
+   // stream the lines are read from, nullptr when lexing a range in place
+   istream *is_;
 
-   // keeps track of how many characters have been called by get()
-   int numCharsAdvanced_;
+   // the current line when reading from a stream
+   string line_;
+
+   // start of the line being lexed
+   const char *begin_;
+
+   // next character to lex
+   const char *cursor_;
+
+   // one past the last character of the line
+   const char *end_;
+
+   // values of the numbers that do not fit in a token, a big number token
+   // holds the index of its value. They are dropped when the next line of a
+   // stream is read, so they are freed with the line instead of kept for
+   // the whole script.
+   vector<Rational> numbers_;
+
+   /**
+    * @brief lex
+    * this function reads the token that starts at cursor and moves cursor
+    * past it
+    *
+    * @param cursor : next character to lex
+    * @param rhs : the token that was read, it is written in place so the
+    * token is not copied after its position is set
+    */
+   void lex(const char *&cursor, Token &rhs);
+
+   /**
+    * @brief fill
+    * this function reads the next line of the stream once the current line
+    * has been lexed. The end of the stream reads as a line that is a .
+    *
+    * @return true : if there is a character to lex
+    * @return false : at the end of a line that was given in memory
+    */
+   bool fill();
 
 public:
    /**
     * @brief Construct a new Token Stream object
-    * constructor that initializes the istream object and sets numCharsAdvances_
-    * to 0
+    * constructor that reads the input stream a line at a time
     * @param inputStream : istream object
     */
    TokenStream(istream &inputStream);
 
+   /**
+    * @brief Construct a new Token Stream object
+    * constructor that lexes a line that is already in memory. The characters
+    * are not copied, they have to outlive the stream.
+    * @param begin : first character of the line
+    * @param end : one past the last character of the line
+    */
+   TokenStream(const char *begin, const char *end);
+
    /**
     * operator>>
-    * this function takes in the input stream and initializes tokens
-    * based on the characters from the input stream
+    * this function reads the next token. A token records where its text is
+    * in the line it was read from.
     *
     * @param rhs : token
-    * @return TokenStream&: istream
+    * @return TokenStream&: this stream
     */
    TokenStream &operator>>(Token &rhs);
 
+   /**
+    * operator>>
+    * this function reads the tokens up to and including the next eol. The
+    * line is classified many characters at a time with SIMD instructions, so
+    * token boundaries and numbers are found without looking at each
+    * character in turn.
+    *
+    * @param line : the tokens are appended to it
+    * @return TokenStream&: this stream
+    */
+   TokenStream &operator>>(vector<Token> &line);
+
+   /**
+    * @brief bigNumber
+    *
+    * @param t : a number token read from this stream that does not fit in an
+    * int64_t
+    * @return const Rational& : its value, kept until the next line is read
+    */
+   const Rational &bigNumber(const Token &t) const { return numbers_[t.id_]; }
+
+   /**
+    * @brief text
+    *
+    * @param t : a token read from this stream
+    * @return string : the text of the token
+    */
+   string text(const Token &t) const;
+
    /**
     * @brief explicit type converter to a bool which is used to test
     * if there is an error in the input stream
-    * @return true : returns true if there are no erros
+    * @return true : returns true if the next token is not invalid
     * @return false : returns false if errors exist
     */
    explicit operator bool() const;
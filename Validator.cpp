@@ -0,0 +1,190 @@
+/**
+ * @file Validator.cpp
+ * @author Katarina McGaughy
+ * @brief The Validator class checks a line of tokens as the tokens arrive,
+ * reporting every error with its column.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include "Validator.h"
+#include <iostream>
+using namespace std;
+
+/**
+ * @brief followers
+ * bit t of row s is set if a token of type t may follow a token of type s.
+ * The row of unknown is the state before the first token. An invalid token
+ * is reported by itself, so anything may follow it or the ending token.
+ */
+static const unsigned short followers[] = {
+    // binop
+    1 << variable | 1 << number | 1 << lparen,
+    // variable
+    1 << binop | 1 << rparen | 1 << powop | 1 << assignop | 1 << eol,
+    // number
+    1 << binop | 1 << rparen | 1 << powop | 1 << eol,
+    // lparen
+    1 << number | 1 << lparen | 1 << variable,
+    // rparen
+    1 << binop | 1 << rparen | 1 << powop | 1 << eol,
+    // unknown
+    1 << variable | 1 << number | 1 << lparen,
+    // powop
+    1 << number | 1 << lparen,
+    // assignop
+    1 << number | 1 << lparen | 1 << variable,
+    // invalid
+    0xffff,
+    // ending
+    0xffff,
+    // eol
+    0};
+
+/**
+ * @brief followerErrors
+ * the error for a token that may not follow a token of each type
+ */
+static const char *const followerErrors[] = {
+    "Invalid character after operator",
+    "Invalid character after variable",
+    "Invalid character after number",
+    "Invalid character after left parenthesis",
+    "Invalid character after right parenthesis",
+    "Invalid first token",
+    "Invalid character after power operator",
+    "Invalid character after assignment operator",
+    "",
+    "",
+    "Invalid character after end of line"};
+
+/**
+ * @brief Construct a new Validator object
+ * ready for the first token of a line
+ */
+Validator::Validator() : exponentDepth_(0), previous_(unknown), count_(0),
+                         valid_(true)
+{
+}
+
+/**
+ * @brief reset
+ * this function gets ready for the first token of the next line, the
+ * memory of the parentheses is kept
+ */
+void Validator::reset()
+{
+   open_.clear();
+   exponentDepth_ = 0;
+   previous_ = unknown;
+   count_ = 0;
+   valid_ = true;
+}
+
+/**
+ * @brief report
+ * this function prints an error and marks the line invalid
+ *
+ * @param message : what is wrong
+ * @param offset : position of the token the error is about
+ */
+void Validator::report(const char *message, uint32_t offset)
+{
+   cout << message << " at column " << offset + 1 << "." << endl;
+   valid_ = false;
+}
+
+/**
+ * @brief accept
+ * this function checks the next token of the line
+ *
+ * @param token : next token
+ * @return true : if the line has no error so far
+ * @return false : if it has one
+ */
+bool Validator::accept(const Token &token)
+{
+   // a line with nothing on it is empty, which is not an error
+   if (token.type_ == eol && previous_ == unknown)
+   {
+      previous_ = eol;
+      return valid_;
+   }
+   if (token.type_ == invalid)
+   {
+      report("Invalid character entered", token.offset_);
+   }
+   else if ((followers[previous_] & (1 << token.type_)) == 0)
+   {
+      report(followerErrors[previous_], token.offset_);
+   }
+
+   switch (token.type_)
+   {
+   case lparen:
+      open_.push_back(token.offset_);
+      if (previous_ == powop && exponentDepth_ == 0)
+      {
+         exponentDepth_ = open_.size();
+      }
+      break;
+   case rparen:
+      if (open_.empty())
+      {
+         report("Unmatched right parenthesis", token.offset_);
+         break;
+      }
+      if (open_.size() == exponentDepth_)
+      {
+         exponentDepth_ = 0;
+      }
+      open_.pop_back();
+      break;
+   case variable:
+      if (exponentDepth_ != 0)
+      {
+         report("Variable in exponent", token.offset_);
+      }
+      break;
+   case assignop:
+      if (count_ != 1)
+      {
+         report("Invalid assignment", token.offset_);
+      }
+      break;
+   default:
+      break;
+   }
+   previous_ = token.type_;
+   count_++;
+   return valid_;
+}
+
+/**
+ * @brief finish
+ * this function checks what can only be checked at the end of the line,
+ * such as left parentheses that were never closed
+ *
+ * @return true : if the line is valid
+ * @return false : if it has an error or is empty
+ */
+bool Validator::finish()
+{
+   // an empty line has no expression, but nothing is wrong with it either
+   if (count_ == 0 && previous_ == eol)
+   {
+      return false;
+   }
+   for (size_t i = 0; i < open_.size(); i++)
+   {
+      report("Unmatched left parenthesis", open_[i]);
+   }
+   if (previous_ != eol)
+   {
+      cout << "Invalid last token." << endl;
+      valid_ = false;
+   }
+   return valid_;
+}
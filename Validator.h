@@ -0,0 +1,92 @@
+/**
+ * @file Validator.h
+ * @author Katarina McGaughy
+ * @brief The Validator class checks a line of tokens as the tokens arrive.
+ * Each token is checked against the type of the token before it in a table
+ * of followers, and the parentheses are counted on the way. Checking goes on
+ * after an error, so every error of the line is reported with its column.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Token.h"
+#pragma once
+using namespace std;
+
+class Validator
+{
+
+private:
+   // column of each left parenthesis that is still open
+   vector<uint32_t> open_;
+
+   // number of open parentheses when the exponent of a power was opened,
+   // 0 outside such an exponent
+   size_t exponentDepth_;
+
+   // type of the last token, unknown before the first token
+   TokenType previous_;
+
+   // number of tokens that were accepted
+   size_t count_;
+
+   // false once an error was found
+   bool valid_;
+
+   /**
+    * @brief report
+    * this function prints an error and marks the line invalid
+    *
+    * @param message : what is wrong
+    * @param offset : position of the token the error is about
+    */
+   void report(const char *message, uint32_t offset);
+
+public:
+   /**
+    * @brief Construct a new Validator object
+    * ready for the first token of a line
+    */
+   Validator();
+
+   /**
+    * @brief reset
+    * this function gets ready for the first token of the next line, the
+    * memory of the parentheses is kept
+    */
+   void reset();
+
+   /**
+    * @brief accept
+    * this function checks the next token of the line
+    *
+    * @param token : next token
+    * @return true : if the line has no error so far
+    * @return false : if it has one
+    */
+   bool accept(const Token &token);
+
+   /**
+    * @brief finish
+    * this function checks what can only be checked at the end of the line,
+    * such as left parentheses that were never closed
+    *
+    * @return true : if the line is valid
+    * @return false : if it has an error or is empty, nothing is reported
+    * for an empty line
+    */
+   bool finish();
+
+   /**
+    * @brief valid
+    *
+    * @return true : if the line has no error so far
+    * @return false : if it has one
+    */
+   bool valid() const { return valid_; }
+};
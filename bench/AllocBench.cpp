@@ -0,0 +1,119 @@
+/**
+ * @file AllocBench.cpp
+ * @author Katarina McGaughy
+ * @brief Check of the allocations made while solving simple lines. Global
+ * operator new is replaced by one that counts its calls, and each line is
+ * solved many times through Calc::calculateBatch. Once the arena, the
+ * bytecode and the stored values of the calculator are warm, a line that
+ * folds to a machine integer or only names variables must not allocate
+ * more than a small, fixed number of times however often it is solved.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/AllocBench.cpp AST.cpp Arena.cpp
+ *        BatchEval.cpp BigInt.cpp Bytecode.cpp Calc.cpp FlatAST.cpp
+ *        LineReader.cpp MappedFile.cpp Parser.cpp Rational.cpp
+ *        SymbolTable.cpp Symbols.cpp ThreadPool.cpp Token.cpp
+ *        TokenStream.cpp Validator.cpp -pthread -o allocbench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "Calc.h"
+using namespace std;
+
+// number of calls to operator new since the program started
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+   allocations++;
+   void *p = malloc(size == 0 ? 1 : size);
+   if (p == nullptr)
+   {
+      throw bad_alloc();
+   }
+   return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+/**
+ * @brief NullBuffer
+ * stream buffer that drops what is written to it, so writing the
+ * solutions does not allocate
+ */
+struct NullBuffer : streambuf
+{
+   int overflow(int c) override { return c; }
+   streamsize xsputn(const char *, streamsize n) override { return n; }
+};
+
+/**
+ * @brief allocationsPerLine
+ * solves a line many times and returns the allocations made per line. The
+ * script is solved once before counting so the calculator is warm.
+ *
+ * @param calc : calculator holding the variables
+ * @param line : line to solve
+ * @return double : average number of allocations per line
+ */
+double allocationsPerLine(Calc &calc, const string &line)
+{
+   const int lines = 1000;
+   string script;
+   for (int i = 0; i < lines; i++)
+   {
+      script += line;
+      script += '\n';
+   }
+   NullBuffer buffer;
+   ostream out(&buffer);
+   calc.calculateBatch(script.data(), script.data() + script.size(), out);
+   size_t before = allocations;
+   calc.calculateBatch(script.data(), script.data() + script.size(), out);
+   return double(allocations - before) / lines;
+}
+
+int main()
+{
+   // most allocations a simple line may make, on average
+   const double bound = 1.0;
+
+   Calc calc;
+   NullBuffer buffer;
+   ostream out(&buffer);
+   const char setup[] = "a:=3\nb:=a*4\nc:=b+a\n";
+   calc.calculateBatch(setup, setup + sizeof(setup) - 1, out);
+
+   const char *simple[] = {"1+2*3", "(7-2)^3/5", "a+b", "c*c-a", "d+e",
+                           "a*(d-1)"};
+   bool passed = true;
+   for (int i = 0; i < sizeof(simple) / sizeof(simple[0]); i++)
+   {
+      double perLine = allocationsPerLine(calc, simple[i]);
+      bool ok = perLine <= bound;
+      passed = passed && ok;
+      printf("%-12s %6.2f allocations per line  %s\n", simple[i], perLine,
+             ok ? "ok" : "FAIL");
+   }
+
+   // lines that store a tree or work on fractions allocate, they are
+   // reported but not checked
+   const char *other[] = {"x:=3*y", "7/2", "(1/3)*m"};
+   for (int i = 0; i < sizeof(other) / sizeof(other[0]); i++)
+   {
+      printf("%-12s %6.2f allocations per line\n", other[i],
+             allocationsPerLine(calc, other[i]));
+   }
+   return passed ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file DeepBench.cpp
+ * @author Katarina McGaughy
+ * @brief Benchmark of the tree walks on trees with a million nodes. Every
+ * walk keeps its own stack, so a chain as deep as the tree is long is
+ * built, copied, simplified and printed, with every parenthesis and with
+ * the fewest, without recursion. It also simplifies the last variable of a
+ * long chain of definitions that each use the one before.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/DeepBench.cpp AST.cpp Arena.cpp Token.cpp
+ *        Symbols.cpp SymbolTable.cpp TokenStream.cpp BigInt.cpp Rational.cpp
+ *        Bytecode.cpp FlatAST.cpp -o deepbench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "FlatAST.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+using namespace std;
+
+/**
+ * @brief leftChain
+ * builds the postfix form of a+1+a+1+..., a tree that leans to the left
+ *
+ * @param leaves : number of operands
+ * @return vector<Token> : postfix vector of tokens
+ */
+vector<Token> leftChain(int leaves)
+{
+   vector<Token> postfix;
+   for (int i = 0; i < leaves; i++)
+   {
+      postfix.push_back(i % 2 == 0 ? Token::fromVariable(Symbols::letter('a'))
+                                   : Token::fromNumber(1));
+      if (i > 0)
+      {
+         postfix.push_back(Token(binop, opAdd));
+      }
+   }
+   return postfix;
+}
+
+/**
+ * @brief rightChain
+ * builds the postfix form of a-(1-(a-(1-...))), a tree that leans to the
+ * right
+ *
+ * @param leaves : number of operands
+ * @return vector<Token> : postfix vector of tokens
+ */
+vector<Token> rightChain(int leaves)
+{
+   vector<Token> postfix;
+   for (int i = 0; i < leaves; i++)
+   {
+      postfix.push_back(i % 2 == 0 ? Token::fromVariable(Symbols::letter('a'))
+                                   : Token::fromNumber(1));
+   }
+   for (int i = 1; i < leaves; i++)
+   {
+      postfix.push_back(Token(binop, opSub));
+   }
+   return postfix;
+}
+
+/**
+ * @brief milliseconds
+ *
+ * @param start : when the timed work started
+ * @return double : milliseconds since start
+ */
+double milliseconds(chrono::steady_clock::time_point start)
+{
+   return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+       .count();
+}
+
+/**
+ * @brief walkTree
+ * times every walk on one tree and prints a row of the table
+ *
+ * @param label : name of the tree
+ * @param postfix : postfix vector of tokens of the tree
+ */
+void walkTree(const string &label, vector<Token> &postfix)
+{
+   SymbolTable variables;
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   AST ast = AST(postfix);
+   double build = milliseconds(start);
+
+   start = chrono::steady_clock::now();
+   AST copy = AST(ast);
+   double copied = milliseconds(start);
+
+   start = chrono::steady_clock::now();
+   string infix = ast.toInfix(ast);
+   double printed = milliseconds(start);
+
+   start = chrono::steady_clock::now();
+   string fewest;
+   ast.toInfix(fewest, fewestParentheses);
+   double trimmed = milliseconds(start);
+
+   // nothing is assigned, so the walk finds nothing to change
+   start = chrono::steady_clock::now();
+   AST same = ast.simplifyTree(variables);
+   double unchanged = milliseconds(start);
+
+   // every operator folds once a has a value
+   variables.assign("a", AST(Token::fromNumber(2)));
+   start = chrono::steady_clock::now();
+   AST folded = ast.simplifyTree(variables);
+   double folding = milliseconds(start);
+
+   start = chrono::steady_clock::now();
+   FlatAST flat = FlatAST(ast).simplify(variables);
+   double flattened = milliseconds(start);
+
+   cout << label << "  " << postfix.size() << " nodes  build " << build
+        << " ms  copy " << copied << " ms  print " << printed
+        << " ms  print fewest " << trimmed << " ms  simplify " << unchanged << " ms  fold " << folding
+        << " ms  flat " << flattened << " ms  = " << folded.toInfix(folded)
+        << " " << flat.toInfix() << endl;
+}
+
+/**
+ * @brief nameOf
+ *
+ * @param i : index of a variable of the chain
+ * @return string : name of the variable, four letters after a v
+ */
+string nameOf(int i)
+{
+   string name = "v";
+   for (int digit = 0; digit < 4; digit++)
+   {
+      name += char('a' + i % 26);
+      i /= 26;
+   }
+   return name;
+}
+
+/**
+ * @brief walkDefinitions
+ * assigns v0 := 1 and vi := v(i-1) + 1 and simplifies the last variable,
+ * which substitutes every definition of the chain
+ *
+ * @param length : number of definitions
+ */
+void walkDefinitions(int length)
+{
+   SymbolTable variables;
+   variables.assign(nameOf(0), AST(Token::fromNumber(1)));
+   for (int i = 1; i < length; i++)
+   {
+      vector<Token> postfix;
+      postfix.push_back(Token::fromVariable(Symbols::intern(nameOf(i - 1))));
+      postfix.push_back(Token::fromNumber(1));
+      postfix.push_back(Token(binop, opAdd));
+      variables.assign(nameOf(i), AST(postfix));
+   }
+   AST last = AST(Token::fromVariable(Symbols::intern(nameOf(length - 1))));
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   AST first = last.simplifyTree(variables);
+   double expanded = milliseconds(start);
+
+   // the values are kept, so the second time nothing is expanded
+   start = chrono::steady_clock::now();
+   AST second = last.simplifyTree(variables);
+   double kept = milliseconds(start);
+
+   // flat storage is simplified by the same walk, so it uses the values
+   // kept as well
+   start = chrono::steady_clock::now();
+   FlatAST flat = FlatAST(last).simplify(variables);
+   double flattened = milliseconds(start);
+
+   cout << "definitions  " << length << " deep  first " << expanded
+        << " ms  kept " << kept << " ms  flat kept " << flattened
+        << " ms  = " << first.toInfix(first) << " " << flat.toInfix() << endl;
+}
+
+int main()
+{
+   vector<Token> left = leftChain(500000);
+   walkTree("left chain ", left);
+   vector<Token> right = rightChain(500000);
+   walkTree("right chain", right);
+   walkDefinitions(100000);
+   return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file FoldBench.cpp
+ * @author Katarina McGaughy
+ * @brief Benchmark of constant folding on deep trees. It times
+ * AST::simplifyTree, which folds on machine integers, against a copy of the
+ * old folding code that parsed every operand with stoi and formatted every
+ * result with to_string.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/FoldBench.cpp AST.cpp Arena.cpp Token.cpp
+ *        Symbols.cpp SymbolTable.cpp TokenStream.cpp BigInt.cpp Rational.cpp
+ *        Bytecode.cpp -o foldbench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "SymbolTable.h"
+using namespace std;
+
+/**
+ * @brief StringNode
+ * node of the old tree, every token carried its text
+ */
+struct StringNode
+{
+   bool isNumber;
+   string value;
+   StringNode *left;
+   StringNode *right;
+};
+
+/**
+ * @brief build
+ * builds the old tree for the same left leaning chain as the AST
+ *
+ * @param postfix : postfix vector of tokens
+ * @return StringNode* : root of the tree
+ */
+StringNode *build(const vector<Token> &postfix)
+{
+   vector<StringNode *> stack;
+   for (int i = 0; i < postfix.size(); i++)
+   {
+      if (postfix[i].type_ == number)
+      {
+         stack.push_back(new StringNode{true, postfix[i].toString(), nullptr,
+                                        nullptr});
+      }
+      else
+      {
+         StringNode *right = stack.back();
+         stack.pop_back();
+         StringNode *left = stack.back();
+         stack.pop_back();
+         stack.push_back(new StringNode{false, postfix[i].toString(), left,
+                                        right});
+      }
+   }
+   return stack.back();
+}
+
+StringNode *copy(const StringNode *node)
+{
+   if (node == nullptr)
+   {
+      return nullptr;
+   }
+   return new StringNode{node->isNumber, node->value, copy(node->left),
+                         copy(node->right)};
+}
+
+void destroy(StringNode *node)
+{
+   if (node == nullptr)
+   {
+      return;
+   }
+   destroy(node->left);
+   destroy(node->right);
+   delete node;
+}
+
+/**
+ * @brief stringCalc
+ * the old calc, operands and result go through text
+ */
+string stringCalc(string leftOperand, string binop, string rightOperand)
+{
+   int left = stoi(leftOperand);
+   int right = stoi(rightOperand);
+   int solution;
+   if (binop == "+")
+   {
+      solution = left + right;
+   }
+   else if (binop == "-")
+   {
+      solution = left - right;
+   }
+   else
+   {
+      solution = left * right;
+   }
+   return to_string(solution);
+}
+
+void stringFold(StringNode *&root)
+{
+   if (root == nullptr || root->isNumber)
+   {
+      return;
+   }
+   stringFold(root->left);
+   stringFold(root->right);
+   if (root->left->isNumber && root->right->isNumber)
+   {
+      root->value = stringCalc(root->left->value, root->value,
+                               root->right->value);
+      root->isNumber = true;
+      delete root->left;
+      delete root->right;
+      root->left = nullptr;
+      root->right = nullptr;
+   }
+}
+
+int main()
+{
+   const int depths[] = {100, 1000, 10000};
+
+   cout << "depth   string fold (ns/node)   native fold (ns/node)" << endl;
+   for (int d = 0; d < 3; d++)
+   {
+      int depth = depths[d];
+      // ((((7+1)-1)+2)-2)... every -k takes back the +k before it, so the
+      // value stays between 7 and 16 and fits an int at any depth
+      vector<Token> postfix;
+      postfix.push_back(Token::fromNumber(7));
+      for (int i = 0; i < depth; i++)
+      {
+         postfix.push_back(Token::fromNumber(i / 2 % 9 + 1));
+         postfix.push_back(Token(binop, i % 2 == 0 ? opAdd : opSub));
+      }
+      int repeat = 2000000 / depth;
+
+      StringNode *oldTree = build(postfix);
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++)
+      {
+         StringNode *tree = copy(oldTree);
+         stringFold(tree);
+         destroy(tree);
+      }
+      double oldTime = chrono::duration<double, nano>(
+                           chrono::steady_clock::now() - start)
+                           .count();
+      destroy(oldTree);
+
+      SymbolTable variables;
+      AST ast = AST(postfix);
+      // one scratch arena reused for every copy, as Calc::calculate does
+      shared_ptr<Arena> scratch = make_shared<Arena>();
+      start = chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++)
+      {
+         {
+            AST simplified = ast.simplifyTree(variables, scratch);
+         }
+         scratch->reset();
+      }
+      double newTime = chrono::duration<double, nano>(
+                           chrono::steady_clock::now() - start)
+                           .count();
+
+      double nodes = double(repeat) * postfix.size();
+      cout << depth << "\t" << oldTime / nodes << "\t\t\t" << newTime / nodes
+           << endl;
+   }
+   return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file LexBench.cpp
+ * @author Katarina McGaughy
+ * @brief Benchmark of lexing one long numeric expression. It times a copy of
+ * the old lexer, which looked at one character at a time and built every
+ * number a digit at a time, against reading a Token at a time and a whole
+ * line at a time from a TokenStream, which find digits 32 characters at a
+ * time.
+ *
+ * Build from the repository root, -march=native selects the AVX2 kernel
+ * where the machine has it:
+ *    g++ -std=c++17 -O2 -march=native -I. bench/LexBench.cpp Token.cpp
+ *        Symbols.cpp TokenStream.cpp BigInt.cpp Rational.cpp -o lexbench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Symbols.h"
+#include "TokenStream.h"
+using namespace std;
+
+/**
+ * @brief oldLex
+ * the old lexer on a range of characters: a switch per character and a
+ * loop per digit
+ *
+ * @param begin : first character
+ * @param end : one past the last character
+ * @param line : receives the tokens
+ */
+static void oldLex(const char *begin, const char *end, vector<Token> &line)
+{
+   const char *p = begin;
+   while (p != end)
+   {
+      char c = *p++;
+      switch (c)
+      {
+      case '(':
+         line.push_back(Token(lparen));
+         break;
+      case ')':
+         line.push_back(Token(rparen));
+         break;
+      case '+':
+         line.push_back(Token(binop, opAdd));
+         break;
+      case '-':
+         line.push_back(Token(binop, opSub));
+         break;
+      case '*':
+         line.push_back(Token(binop, opMul));
+         break;
+      case '/':
+         line.push_back(Token(binop, opDiv));
+         break;
+      case '^':
+         line.push_back(Token(powop, opPow));
+         break;
+      case '\n':
+         line.push_back(Token(eol));
+         return;
+      default:
+         if (isdigit(c))
+         {
+            int64_t value = c - '0';
+            while (p != end && isdigit(*p))
+            {
+               value = value * 10 + (*p++ - '0');
+            }
+            line.push_back(Token::fromNumber(value));
+         }
+         else if (isalpha(c))
+         {
+            line.push_back(Token::fromVariable(Symbols::letter(tolower(c))));
+         }
+         else
+         {
+            line.push_back(Token(invalid));
+         }
+      }
+   }
+}
+
+int main()
+{
+   // 1 million terms of numbers with 1 to 18 digits
+   string expression;
+   unsigned seed = 1;
+   const char operators[] = "+-*/";
+   for (int i = 0; i < 1000000; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      int digits = 1 + (seed >> 8) % 18;
+      for (int d = 0; d < digits; d++)
+      {
+         seed = seed * 1103515245 + 12345;
+         expression += char('1' + (seed >> 16) % 9);
+      }
+      expression += operators[i % 4];
+   }
+   expression += "1\n";
+   const char *begin = expression.data();
+   const char *end = begin + expression.size();
+   // the best of several rounds, the first rounds also warm the caches
+   const int rounds = 10;
+   double oldTime = 1e9;
+   double singleTime = 1e9;
+   double lineTime = 1e9;
+   vector<Token> expected;
+   vector<Token> single;
+   vector<Token> line;
+   for (int r = 0; r < rounds; r++)
+   {
+      expected.clear();
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      oldLex(begin, end, expected);
+      oldTime = min(oldTime, chrono::duration<double>(
+                                 chrono::steady_clock::now() - start)
+                                 .count());
+
+      single.clear();
+      start = chrono::steady_clock::now();
+      TokenStream tokens(begin, end);
+      Token tok;
+      do
+      {
+         tokens >> tok;
+         single.push_back(tok);
+      } while (tok.type_ != eol);
+      singleTime = min(singleTime, chrono::duration<double>(
+                                       chrono::steady_clock::now() - start)
+                                       .count());
+
+      line.clear();
+      start = chrono::steady_clock::now();
+      TokenStream lines(begin, end);
+      lines >> line;
+      lineTime = min(lineTime, chrono::duration<double>(
+                                   chrono::steady_clock::now() - start)
+                                   .count());
+   }
+
+   if (single.size() != expected.size() || line.size() != expected.size())
+   {
+      cout << "token counts differ" << endl;
+      return 1;
+   }
+   for (size_t i = 0; i < expected.size(); i++)
+   {
+      if (single[i].type_ != expected[i].type_ ||
+          single[i].number_ != expected[i].number_ ||
+          line[i].type_ != expected[i].type_ ||
+          line[i].number_ != expected[i].number_)
+      {
+         cout << "token " << i << " differs" << endl;
+         return 1;
+      }
+   }
+   double bytes = double(expression.size());
+   cout << "old lexer:          " << bytes / oldTime / 1e6 << " MB/s" << endl;
+   cout << "a token at a time:  " << bytes / singleTime / 1e6 << " MB/s"
+        << endl;
+   cout << "a line at a time:   " << bytes / lineTime / 1e6 << " MB/s" << endl;
+   return 0;
+}
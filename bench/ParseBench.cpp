@@ -0,0 +1,151 @@
+/**
+ * @file ParseBench.cpp
+ * @author Katarina McGaughy
+ * @brief Benchmark of parsing expressions into trees. It times lexing the
+ * line into a vector, Calc::isValid, Calc::convertPostfix and building the
+ * AST from the postfix vector against the Parser, which builds the tree while it reads
+ * the tokens, with the shunting-yard algorithm and by precedence climbing.
+ * The lines are 80 tokens long with the end of line.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/ParseBench.cpp Calc.cpp Parser.cpp
+ *        Validator.cpp AST.cpp FlatAST.cpp Arena.cpp Token.cpp Symbols.cpp
+ *        SymbolTable.cpp TokenStream.cpp LineReader.cpp BigInt.cpp
+ *        Rational.cpp Bytecode.cpp -o parsebench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "Arena.h"
+#include "Calc.h"
+#include "Parser.h"
+#include "TokenStream.h"
+using namespace std;
+
+int main()
+{
+   // 79 tokens: (a+12)*b-345/(c-6)^2+... with every operator and nesting
+   string line;
+   const char *pieces[] = {"(a+12)*b", "-", "345/(c-6)^2", "+", "d*(e-(7+f))",
+                           "/", "8^3", "-", "g"};
+   while (true)
+   {
+      string longer = line;
+      for (int i = 0; i < 9; i++)
+      {
+         longer += pieces[i];
+      }
+      longer += "+";
+      vector<Token> tokens;
+      TokenStream count(longer.data(), longer.data() + longer.size());
+      count >> tokens;
+      if (tokens.size() > 78)
+      {
+         break;
+      }
+      line = longer;
+   }
+   line += "1\n";
+   const char *begin = line.data();
+   const char *end = begin + line.size();
+   const int lines = 100000;
+   const int rounds = 5;
+
+   Calc calc;
+   Parser stackParser(shuntingYard);
+   Parser climbingParser(precedenceClimbing);
+   shared_ptr<Arena> arena = make_shared<Arena>();
+   double postfixTime = 1e9;
+   double stackTime = 1e9;
+   double climbingTime = 1e9;
+   // counts the lines that parsed, so no loop can be left out
+   size_t parsed = 0;
+   for (int r = 0; r < rounds; r++)
+   {
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (int i = 0; i < lines; i++)
+      {
+         arena->reset();
+         TokenStream tokens(begin, end);
+         vector<Token> infix;
+         tokens >> infix;
+         if (calc.isValid(infix))
+         {
+            vector<Token> postfix = calc.convertPostfix(infix);
+            AST ast = AST(postfix, arena);
+            parsed++;
+         }
+      }
+      postfixTime = min(postfixTime, chrono::duration<double>(
+                                         chrono::steady_clock::now() - start)
+                                         .count());
+
+      start = chrono::steady_clock::now();
+      for (int i = 0; i < lines; i++)
+      {
+         arena->reset();
+         TokenStream tokens(begin, end);
+         AST ast = AST(arena);
+         parsed += stackParser.parse(tokens, ast);
+      }
+      stackTime = min(stackTime, chrono::duration<double>(
+                                     chrono::steady_clock::now() - start)
+                                     .count());
+
+      start = chrono::steady_clock::now();
+      for (int i = 0; i < lines; i++)
+      {
+         arena->reset();
+         TokenStream tokens(begin, end);
+         AST ast = AST(arena);
+         parsed += climbingParser.parse(tokens, ast);
+      }
+      climbingTime = min(climbingTime, chrono::duration<double>(
+                                           chrono::steady_clock::now() - start)
+                                           .count());
+   }
+
+   // the three trees print the same
+   TokenStream tokens(begin, end);
+   vector<Token> infix;
+   tokens >> infix;
+   vector<Token> postfix = calc.convertPostfix(infix);
+   AST fromPostfix = AST(postfix);
+   TokenStream stackTokens(begin, end);
+   AST fromStack;
+   stackParser.parse(stackTokens, fromStack);
+   TokenStream climbingTokens(begin, end);
+   AST fromClimbing;
+   climbingParser.parse(climbingTokens, fromClimbing);
+   string expected = fromPostfix.toInfix(fromPostfix);
+   if (fromStack.toInfix(fromStack) != expected ||
+       fromClimbing.toInfix(fromClimbing) != expected)
+   {
+      cout << "trees differ" << endl;
+      return 1;
+   }
+
+   if (parsed != size_t(3 * lines * rounds))
+   {
+      cout << "a line did not parse" << endl;
+      return 1;
+   }
+   cout << infix.size() << " tokens a line" << endl;
+   cout << "infix, postfix, AST: " << lines / postfixTime / 1e6
+        << " M lines/s" << endl;
+   cout << "shunting-yard:       " << lines / stackTime / 1e6 << " M lines/s"
+        << endl;
+   cout << "precedence climbing: " << lines / climbingTime / 1e6
+        << " M lines/s" << endl;
+   return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file ScaleBench.cpp
+ * @author Katarina McGaughy
+ * @brief Benchmark of one expression of growing length, from a thousand to
+ * ten million tokens. Each line is solved through Calc::calculateBatch,
+ * which lexes, parses, simplifies and prints it, with the trees stored as
+ * nodes, as flat vectors and parsed by precedence climbing. The time per
+ * token stays about the same as the line grows when every step is linear.
+ * The rows are printed as columns that can be plotted.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/ScaleBench.cpp AST.cpp Arena.cpp
+ *        BatchEval.cpp BigInt.cpp Bytecode.cpp Calc.cpp FlatAST.cpp
+ *        LineReader.cpp MappedFile.cpp Parser.cpp Rational.cpp
+ *        SymbolTable.cpp Symbols.cpp ThreadPool.cpp Token.cpp
+ *        TokenStream.cpp Validator.cpp -pthread -o scalebench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "Calc.h"
+using namespace std;
+
+/**
+ * @brief NullBuffer
+ * stream buffer that drops what is written to it, so the time is not spent
+ * writing the solution
+ */
+struct NullBuffer : streambuf
+{
+   int overflow(int c) override { return c; }
+   streamsize xsputn(const char *, streamsize n) override { return n; }
+};
+
+/**
+ * @brief expression
+ * builds one line of terms such as a*2+(b-3)^2-c/(d+1), some of which fold
+ * and some of which are left as they are
+ *
+ * @param tokens : least number of tokens of the line
+ * @param count : receives the number of tokens of the line
+ * @return string : the line, ending with '\n'
+ */
+string expression(size_t tokens, size_t &count)
+{
+   const char *terms[] = {"a*2", "(b-3)^2", "c/(d+1)", "4*5", "e"};
+   const size_t sizes[] = {3, 7, 7, 3, 1};
+   string line;
+   count = 0;
+   for (size_t i = 0; count < tokens; i++)
+   {
+      if (i > 0)
+      {
+         line += i % 2 == 0 ? '+' : '-';
+         count++;
+      }
+      line += terms[i % 5];
+      count += sizes[i % 5];
+   }
+   line += '\n';
+   return line;
+}
+
+/**
+ * @brief solve
+ * solves the line once with a new calculator
+ *
+ * @param line : the line
+ * @param storage : how the calculator stores trees
+ * @param parse : how the calculator parses lines
+ * @return double : milliseconds taken
+ */
+double solve(const string &line, StorageMode storage, ParseMode parse)
+{
+   Calc calc(storage, parse);
+   NullBuffer buffer;
+   ostream out(&buffer);
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   calc.calculateBatch(line.data(), line.data() + line.size(), out);
+   return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+       .count();
+}
+
+int main()
+{
+   printf("%10s %10s %10s %10s %10s %10s %10s\n", "tokens", "tree ms",
+          "ns/token", "flat ms", "ns/token", "pratt ms", "ns/token");
+   for (size_t tokens = 1000; tokens <= 10000000; tokens *= 10)
+   {
+      size_t count;
+      string line = expression(tokens, count);
+      double tree = solve(line, treeStorage, shuntingYard);
+      double flat = solve(line, flatStorage, shuntingYard);
+      double pratt = solve(line, treeStorage, precedenceClimbing);
+      printf("%10zu %10.2f %10.1f %10.2f %10.1f %10.2f %10.1f\n", count,
+             tree, tree * 1e6 / count, flat, flat * 1e6 / count, pratt,
+             pratt * 1e6 / count);
+   }
+   return 0;
+}
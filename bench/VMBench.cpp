@@ -0,0 +1,118 @@
+/**
+ * @file VMBench.cpp
+ * @author Katarina McGaughy
+ * @brief Benchmark of evaluating a stored expression many times. It times
+ * AST::simplifyTree, which rebuilds the tree with the variables filled in
+ * and folded, against AST::simplify, which compiles the tree to bytecode once
+ * and runs it on the stack machine after that.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/VMBench.cpp AST.cpp Arena.cpp Token.cpp
+ *        Symbols.cpp SymbolTable.cpp TokenStream.cpp BigInt.cpp Rational.cpp
+ *        Bytecode.cpp -o vmbench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+using namespace std;
+
+/**
+ * @brief sumOfProducts
+ * builds the postfix form of a*b+c*2-a*c+b*b... with the given number of
+ * products, the values stay small so nothing overflows
+ *
+ * @param terms : number of products
+ * @return vector<Token> : postfix vector of tokens
+ */
+vector<Token> sumOfProducts(int terms)
+{
+   const Token leaves[] = {Token::fromVariable(Symbols::letter('a')),
+                           Token::fromVariable(Symbols::letter('b')),
+                           Token::fromVariable(Symbols::letter('c')),
+                           Token::fromNumber(2)};
+   vector<Token> postfix;
+   for (int i = 0; i < terms; i++)
+   {
+      postfix.push_back(leaves[i % 4]);
+      postfix.push_back(leaves[(i * 3 + 1) % 4]);
+      postfix.push_back(Token(binop, opMul));
+      if (i > 0)
+      {
+         postfix.push_back(Token(binop, i % 2 == 1 ? opAdd : opSub));
+      }
+   }
+   return postfix;
+}
+
+int main()
+{
+   SymbolTable variables;
+   variables.assign("a", AST(Token::fromNumber(3)));
+   variables.assign("b", AST(Token::fromNumber(5)));
+   variables.assign("c", AST(Token::fromNumber(7)));
+
+   const int terms[] = {2, 8, 32};
+
+   cout << "nodes   tree walk (ns/eval)   bytecode (ns/eval)" << endl;
+   for (int t = 0; t < 3; t++)
+   {
+      vector<Token> postfix = sumOfProducts(terms[t]);
+      AST ast = AST(postfix);
+      int repeat = 20000000 / postfix.size();
+      shared_ptr<Arena> scratch = make_shared<Arena>();
+
+      string walked;
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++)
+      {
+         {
+            AST simplified = ast.simplifyTree(variables, scratch);
+            if (r == 0)
+            {
+               walked = ast.toInfix(simplified);
+            }
+         }
+         scratch->reset();
+      }
+      double treeTime = chrono::duration<double, nano>(
+                            chrono::steady_clock::now() - start)
+                            .count();
+
+      string run;
+      start = chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++)
+      {
+         {
+            AST simplified = ast.simplify(variables, scratch);
+            if (r == 0)
+            {
+               run = ast.toInfix(simplified);
+            }
+         }
+         scratch->reset();
+      }
+      double codeTime = chrono::duration<double, nano>(
+                            chrono::steady_clock::now() - start)
+                            .count();
+
+      if (walked != run)
+      {
+         cout << "results differ: " << walked << " " << run << endl;
+         return 1;
+      }
+      cout << postfix.size() << "\t" << treeTime / repeat << "\t\t\t"
+           << codeTime / repeat << endl;
+   }
+   return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file ValueBench.cpp
+ * @author Katarina McGaughy
+ * @brief Check of the solutions of short scripts. Each script is solved
+ * through Calc::calculateBatch with the trees stored as nodes and as flat
+ * vectors, and every solution is compared with the one expected, which is
+ * the same in both storages. The scripts use a variable more than once, so
+ * a value kept for it must give the same solution every time it is used.
+ *
+ * Build from the repository root:
+ *    g++ -std=c++17 -O2 -I. bench/ValueBench.cpp AST.cpp Arena.cpp
+ *        BatchEval.cpp BigInt.cpp Bytecode.cpp Calc.cpp FlatAST.cpp
+ *        LineReader.cpp MappedFile.cpp Parser.cpp Rational.cpp
+ *        SymbolTable.cpp Symbols.cpp ThreadPool.cpp Token.cpp
+ *        TokenStream.cpp Validator.cpp -pthread -o valuebench
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "Calc.h"
+using namespace std;
+
+/**
+ * @brief Case
+ * a script and the solutions expected, one per line
+ */
+struct Case
+{
+   const char *script;
+   const char *solved;
+};
+
+/**
+ * @brief solveScript
+ *
+ * @param script : lines of the script
+ * @param mode : how the calculator stores trees
+ * @return string : the solutions, one per line
+ */
+string solveScript(const string &script, StorageMode mode)
+{
+   Calc calc(mode, precedenceClimbing);
+   ostringstream out;
+   calc.calculateBatch(script.data(), script.data() + script.size(), out);
+   return out.str();
+}
+
+/**
+ * @brief check
+ * solves a script and compares the solutions with the ones expected
+ *
+ * @param script : lines of the script
+ * @param mode : how the calculator stores trees
+ * @param label : name of the mode
+ * @param expected : the solutions expected
+ * @return true : if every solution is the one expected
+ * @return false : if one is not
+ */
+bool check(const string &script, StorageMode mode, const char *label,
+           const string &expected)
+{
+   string solved = solveScript(script, mode);
+   if (solved == expected)
+   {
+      return true;
+   }
+   printf("FAIL %s\n--- script\n%s--- expected\n%s--- solved\n%s", label,
+          script.c_str(), expected.c_str(), solved.c_str());
+   return false;
+}
+
+int main()
+{
+   const Case cases[] = {
+       // a value that is a fraction or a big number is one node that lives
+       // in the arena of the value
+       {"f:=7/9\nf+u\nf+u\nf/f\n",
+        "(7/9)\n((7/9)+u)\n((7/9)+u)\n1\n"},
+       {"g:=2^100\ng+u\ng+u\ng-g\n",
+        "1267650600228229401496703205376\n"
+        "(1267650600228229401496703205376+u)\n"
+        "(1267650600228229401496703205376+u)\n0\n"},
+       // a variable of a cycle is left as it is where the cycle is first
+       // reached, so its solution must not depend on the order of the
+       // lines
+       {"x:=y\ny:=x\ny\nx\ny\n", "y\nx\ny\nx\ny\n"},
+       {"p:=q+1\nq:=p*2\nq\np\nq\n",
+        "(q+1)\n(((p*2)+1)*2)\n((q+1)*2)\n((p*2)+1)\n((q+1)*2)\n"},
+       {"p:=q+1\nq:=p*2\np\nq\np\n",
+        "(q+1)\n(((p*2)+1)*2)\n((p*2)+1)\n((q+1)*2)\n((p*2)+1)\n"},
+       // a value kept for a variable is dropped when a variable it was
+       // made from is assigned again
+       {"p:=q+1\nr:=p*2\nr\nq:=3\nr\np:=5\nr\n",
+        "(q+1)\n((q+1)*2)\n((q+1)*2)\n3\n8\n5\n10\n"},
+       // a variable reached through a cycle has the same solution alone and
+       // next to the other variables of the cycle
+       {"a:=x/b\nb:=a\nb\na/b\nb/a\na\n",
+        "(x/b)\n(x/a)\n(x/b)\n((x/a)/(x/b))\n((x/b)/(x/a))\n(x/a)\n"},
+       {"a:=x/b\nb:=a\na/b\nb\na\nb/a\n",
+        "(x/b)\n(x/a)\n((x/a)/(x/b))\n(x/b)\n(x/a)\n((x/b)/(x/a))\n"},
+       // a division by 0 that cannot be done is not removed by x*0, x-x or
+       // x^0
+       {"(1/0)*0\n(x/0)-(x/0)\n(1/0)^0\nx*0\nx-x\nx^0\n",
+        "((1/0)*0)\n((x/0)-(x/0))\n((1/0)^0)\n0\n0\n1\n"},
+       // numbers are folded exactly in both storages, and a negative base is
+       // printed in parentheses
+       {"14/4\n(1/3)+(1/6)\n2^100\n(0-2)^(0-2)\n(0-2)^(1/2)\n",
+        "(7/2)\n(1/2)\n1267650600228229401496703205376\n(1/4)\n"
+        "((-2)^(1/2))\n"},
+       // the rules that rewrite an operator apply in both storages
+       {"x+0\n2*x+3*x\n(x+2)+3\n", "x\n(5*x)\n(x+5)\n"},
+   };
+
+   int failed = 0;
+   for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+   {
+      failed += !check(cases[i].script, treeStorage, "tree", cases[i].solved);
+      failed += !check(cases[i].script, flatStorage, "flat", cases[i].solved);
+   }
+   printf("%d scripts, %d failed\n", int(sizeof(cases) / sizeof(cases[0])),
+          failed);
+   return failed == 0 ? 0 : 1;
+}
@@ -1,17 +1,106 @@
-
 #include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
 #include "Calc.h"
+#include "MappedFile.h"
 #include <vector>
 #include "TokenStream.h"
 #include "Token.h"
 #include "AST.h"
 using namespace std;
 
-int main(){
+int main(int argc, char *argv[]){
+
+ // --flat stores the trees of the expressions as flat vectors of nodes
+ // --batch [file] runs a script from the file or stdin without a prompt
+ // --stats reports how fast a script file was read, on stderr
+ // --pratt parses by precedence climbing, which also reads unary minus
+ // --minimal prints the solutions with only the parentheses they need
+ // the script is the first argument that is not a flag, wherever it is, and
+ // is run as with --batch
+ const char *usage = " [--batch] [--flat] [--pratt] [--minimal] [--stats]"
+                     " [file]";
+ StorageMode mode = treeStorage;
+ ParseMode parse = shuntingYard;
+ PrintMode print = fullParentheses;
+ bool batch = false;
+ bool stats = false;
+ const char *script = nullptr;
+ for (int i = 1; i < argc; i++)
+ {
+    if (strcmp(argv[i], "--flat") == 0)
+    {
+       mode = flatStorage;
+    }
+    else if (strcmp(argv[i], "--pratt") == 0)
+    {
+       parse = precedenceClimbing;
+    }
+    else if (strcmp(argv[i], "--minimal") == 0)
+    {
+       print = fewestParentheses;
+    }
+    else if (strcmp(argv[i], "--stats") == 0)
+    {
+       stats = true;
+    }
+    else if (strcmp(argv[i], "--batch") == 0)
+    {
+       batch = true;
+    }
+    else if (argv[i][0] != '-' && script == nullptr)
+    {
+       script = argv[i];
+       batch = true;
+    }
+    else
+    {
+       cerr << (argv[i][0] == '-' ? "Unknown flag " : "Extra argument ")
+            << argv[i] << endl;
+       cerr << "Usage: " << argv[0] << usage << endl;
+       return 1;
+    }
+ }
+
+ if (batch)
+ {
+    // solutions are written in large blocks instead of a flush per line
+    ios::sync_with_stdio(false);
+    Calc calc = Calc(mode, parse, print);
+    if (script == nullptr)
+    {
+       calc.calculateBatch(cin, cout);
+       return 0;
+    }
+    // a regular file is mapped and lexed in place, anything else such as a
+    // named pipe is read as a stream
+    MappedFile mapped;
+    if (mapped.open(script))
+    {
+       chrono::steady_clock::time_point start = chrono::steady_clock::now();
+       calc.calculateBatch(mapped.begin(), mapped.end(), cout);
+       chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+       if (stats)
+       {
+          cerr << mapped.size() << " bytes in " << seconds.count() << " s, "
+               << mapped.size() / seconds.count() / 1e9 << " GB/s" << endl;
+       }
+       return 0;
+    }
+    ifstream file(script, ios::binary);
+    if (!file)
+    {
+       cerr << "Cannot open " << script << endl;
+       return 1;
+    }
+    calc.calculateBatch(file, cout);
+    return 0;
+ }
 
  cout << "Running Calculator Program " << endl;
  cout << "Please input expressions: " << endl;  
- Calc calc = Calc();
+ Calc calc = Calc(mode, parse, print);
  calc.calculate();
 
    return 0;